@@ -0,0 +1,341 @@
+#include <PropertyContext_p.h>
+#include <PropertyGrid.h>
+#include <PropertyGridTreeItem_p.h>
+#include <PropertyGridTreeModel_p.h>
+
+#include <QApplication>
+#include <QTextStream>
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace
+{
+// NOTE: only the thread that runs the checks is counted, whatever Qt's thread pool does in the meantime is left out
+thread_local quint64 allocationsCount = 0;
+
+// ctest reports the checks as skipped where the budgets can't be checked, see SKIP_RETURN_CODE in the CMakeLists.txt
+const int ALLOCATION_BUDGETS_SKIPPED_EXIT_CODE = 77;
+} // namespace
+
+#if defined(__GLIBC__)
+// NOTE: QString and QVariant allocate through malloc() rather than operator new, so that's where the counting happens
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    ++allocationsCount;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    ++allocationsCount;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    ++allocationsCount;
+    return __libc_realloc(pointer, size);
+}
+
+#define ALLOCATION_BUDGETS_COUNTS_MALLOC 1
+#else
+#define ALLOCATION_BUDGETS_COUNTS_MALLOC 0
+#endif
+
+// the budgets are measured on optimized builds, debug builds of Qt and of the grid allocate more
+#if defined(NDEBUG)
+#define ALLOCATION_BUDGETS_IS_OPTIMIZED 1
+#else
+#define ALLOCATION_BUDGETS_IS_OPTIMIZED 0
+#endif
+
+namespace
+{
+void *allocate(std::size_t size) noexcept
+{
+    // on glibc the malloc() above has counted it already
+    if (!ALLOCATION_BUDGETS_COUNTS_MALLOC)
+        ++allocationsCount;
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    void *result = allocate(size);
+    if (result == nullptr)
+        throw std::bad_alloc();
+
+    return result;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+const int ALLOCATION_BUDGETS_ITERATIONS = 100;
+const int ALLOCATION_BUDGETS_PROPERTIES_COUNT = 1000;
+const int ALLOCATION_BUDGETS_CATEGORIES_COUNT = 16;
+
+// NOTE: the budgets are upper bounds per operation. whenever an allocation gets removed from one of these paths,
+//       its budget gets lowered along with it, so that it can't creep back in unnoticed
+const quint64 MODEL_DATA_BUDGET = 0;
+const quint64 SET_PROPERTY_VALUE_BUDGET = 32;
+const quint64 CONTEXT_COPY_BUDGET = 0;
+const quint64 CONTEXT_COPY_PER_ATTRIBUTE_BUDGET = 2; // the copy of the attribute and its node in the map
+
+template <int I>
+struct BudgetAttribute : public PM::Attribute
+{
+    int value = I;
+};
+
+PM::Property createProperty(int index)
+{
+    return PM::Property(QString("property %1").arg(index), QMetaType::Int, PM::DescriptionAttribute(QString("description %1").arg(index)),
+                        PM::CategoryAttribute(QString("category %1").arg(index % ALLOCATION_BUDGETS_CATEGORIES_COUNT)));
+}
+
+QModelIndexList allIndexes(const QAbstractItemModel &model, const QModelIndex &parent = QModelIndex())
+{
+    QModelIndexList result;
+
+    for (int row = 0; row < model.rowCount(parent); ++row)
+    {
+        for (int column = 0; column < model.columnCount(parent); ++column)
+            result.append(model.index(row, column, parent));
+
+        result.append(allIndexes(model, model.index(row, 0, parent)));
+    }
+
+    return result;
+}
+
+class AllocationBudgets
+{
+public:
+    explicit AllocationBudgets(QTextStream &out) : m_out(out), m_failuresCount(0)
+    {
+    }
+
+    // `operation` runs once before the counting starts, lazily initialized statics and caches don't count
+    template <typename Operation>
+    void check(const QString &name, quint64 budget, Operation &&operation)
+    {
+        operation();
+
+        const quint64 allocationsBefore = allocationsCount;
+
+        for (int i = 0; i < ALLOCATION_BUDGETS_ITERATIONS; ++i)
+            operation();
+
+        const quint64 allocations = allocationsCount - allocationsBefore;
+        const bool withinBudget = allocations <= budget * ALLOCATION_BUDGETS_ITERATIONS;
+
+        if (!withinBudget)
+            ++m_failuresCount;
+
+        m_out << (withinBudget ? "PASS   " : "FAIL   ") << name.leftJustified(56);
+        m_out << double(allocations) / ALLOCATION_BUDGETS_ITERATIONS << " allocations (budget " << budget << ")\n";
+        m_out.flush();
+    }
+
+    int failuresCount() const
+    {
+        return m_failuresCount;
+    }
+
+private:
+    QTextStream &m_out;
+    int m_failuresCount;
+};
+
+void checkModelData(AllocationBudgets &budgets)
+{
+    PM::internal::PropertyGridTreeModel model;
+    model.setItemInitializer(
+        [](PM::internal::PropertyGridTreeItem *item)
+        {
+            //
+            item->setColumnData(1, Qt::DisplayRole, item->context.value().toString());
+        });
+
+    std::vector<PM::PropertyContext> contexts;
+    for (int i = 0; i < ALLOCATION_BUDGETS_PROPERTIES_COUNT; ++i)
+        contexts.push_back(PM::PropertyContextPrivate::createContext(createProperty(i), i, nullptr, nullptr));
+
+    model.addProperties(contexts);
+
+    const QModelIndexList indexes = allIndexes(model);
+
+    const std::pair<int, const char *> roles[] = {
+        {Qt::DisplayRole, "DisplayRole"},
+        {Qt::EditRole, "EditRole"},
+        {Qt::DecorationRole, "DecorationRole"},
+        {Qt::FontRole, "FontRole"},
+        {Qt::ToolTipRole, "ToolTipRole"},
+        {Qt::BackgroundRole, "BackgroundRole"},
+        {Qt::ForegroundRole, "ForegroundRole"},
+        {Qt::SizeHintRole, "SizeHintRole"},
+    };
+
+    for (const auto &role : roles)
+    {
+        budgets.check(QString("PropertyGridTreeModel::data(%1), every row").arg(role.second), MODEL_DATA_BUDGET,
+                      [&]()
+                      {
+                          for (const QModelIndex &index : indexes)
+                              model.data(index, role.first);
+                      });
+    }
+}
+
+void checkSetPropertyValue(AllocationBudgets &budgets)
+{
+    PM::PropertyGrid grid;
+
+    for (int i = 0; i < ALLOCATION_BUDGETS_PROPERTIES_COUNT; ++i)
+        grid.addProperty(createProperty(i), i);
+
+    // the same budget holds for a property with more attributes, copies of the property or its context on the way would break it
+    PM::Property heavyProperty = createProperty(ALLOCATION_BUDGETS_PROPERTIES_COUNT);
+    heavyProperty.addAttribute(BudgetAttribute<0>());
+    heavyProperty.addAttribute(BudgetAttribute<1>());
+    heavyProperty.addAttribute(BudgetAttribute<2>());
+    heavyProperty.addAttribute(BudgetAttribute<3>());
+    grid.addProperty(heavyProperty, 0);
+
+    const QString propertyName = createProperty(0).name();
+    const QString heavyPropertyName = heavyProperty.name();
+    int value = 0;
+
+    budgets.check("PropertyGrid::setPropertyValue()", SET_PROPERTY_VALUE_BUDGET,
+                  [&]()
+                  {
+                      //
+                      grid.setPropertyValue(propertyName, ++value);
+                  });
+
+    budgets.check("PropertyGrid::setPropertyValue(), 4 more attributes", SET_PROPERTY_VALUE_BUDGET,
+                  [&]()
+                  {
+                      //
+                      grid.setPropertyValue(heavyPropertyName, ++value);
+                  });
+}
+
+void checkContextCopies(AllocationBudgets &budgets)
+{
+    const PM::PropertyContext context = PM::PropertyContextPrivate::createContext(PM::Property("property", QMetaType::Int), 0, nullptr, nullptr);
+
+    budgets.check("PropertyContext copy, no attributes", CONTEXT_COPY_BUDGET,
+                  [&]()
+                  {
+                      PM::PropertyContext copy = context;
+                      Q_UNUSED(copy)
+                  });
+
+    const PM::PropertyContext attributedContext = PM::PropertyContextPrivate::createContext(createProperty(0), 0, nullptr, nullptr);
+
+    // the attributes' map needs its buckets on top of the attributes themselves
+    budgets.check("PropertyContext copy, 2 attributes", CONTEXT_COPY_BUDGET + 1 + 2 * CONTEXT_COPY_PER_ATTRIBUTE_BUDGET,
+                  [&]()
+                  {
+                      PM::PropertyContext copy = attributedContext;
+                      Q_UNUSED(copy)
+                  });
+
+    // the type ids get summed up, so that the calls don't get optimized away
+    int typesChecksum = 0;
+
+    budgets.check("PropertyContext::property()", 0,
+                  [&]()
+                  {
+                      //
+                      typesChecksum += attributedContext.property().type();
+                  });
+
+    Q_UNUSED(typesChecksum)
+}
+} // namespace
+
+//
+// Checks the allocations of the operations that run on every frame or every edit against fixed budgets, the exit code
+// is the number of checks that went over their budget. run with QT_QPA_PLATFORM=offscreen on headless machines.
+// the checks get skipped on debug builds and where malloc() can't be hooked
+//
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    if (!ALLOCATION_BUDGETS_COUNTS_MALLOC)
+    {
+        out << "SKIPPED: malloc() can't be hooked on this platform, Qt's own allocations would go unnoticed\n";
+        return ALLOCATION_BUDGETS_SKIPPED_EXIT_CODE;
+    }
+
+    if (!ALLOCATION_BUDGETS_IS_OPTIMIZED)
+    {
+        out << "SKIPPED: the budgets only hold for optimized builds\n";
+        return ALLOCATION_BUDGETS_SKIPPED_EXIT_CODE;
+    }
+
+    AllocationBudgets budgets(out);
+
+    checkModelData(budgets);
+    checkSetPropertyValue(budgets);
+    checkContextCopies(budgets);
+
+    return budgets.failuresCount();
+}
@@ -0,0 +1,110 @@
+#include "PropertyEditorFormatting_p.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+
+namespace
+{
+const int FORMATTING_BENCHMARK_ITERATIONS = 1000000;
+
+std::atomic<quint64> allocationsCount(0);
+} // namespace
+
+#if defined(__GLIBC__)
+// NOTE: QString allocates through malloc() rather than operator new, so that's what gets counted
+extern "C" void *__libc_malloc(size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+#define FORMATTING_BENCHMARK_COUNTS_ALLOCATIONS 1
+#else
+#define FORMATTING_BENCHMARK_COUNTS_ALLOCATIONS 0
+#endif
+
+namespace
+{
+using namespace PM::internal;
+
+// the formatting PropertyEditor used before PropertyEditorFormatting_p.h
+QString formatRectWithArg(const QRectF &v)
+{
+    return QString("%1, %2, %3, %4").arg(v.x()).arg(v.y()).arg(v.width()).arg(v.height());
+}
+
+QString formatColorWithArg(const QColor &v)
+{
+    return QString("%1, %2, %3, (%4)").arg(v.red()).arg(v.green()).arg(v.blue()).arg(v.alpha());
+}
+
+void run(QTextStream &out, const char *name, const std::function<QString(int)> &format)
+{
+    // checksum of the lengths, so that nothing gets optimized away
+    qint64 checksum = 0;
+
+    const quint64 allocationsBefore = allocationsCount.load(std::memory_order_relaxed);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < FORMATTING_BENCHMARK_ITERATIONS; ++i)
+        checksum += format(i).size();
+
+    const qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+    const quint64 allocations = allocationsCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    out << QString::fromLatin1(name).leftJustified(28);
+    out << qint64(double(FORMATTING_BENCHMARK_ITERATIONS) * 1e9 / double(elapsed)) << " values/s, ";
+
+    if (FORMATTING_BENCHMARK_COUNTS_ALLOCATIONS)
+        out << double(allocations) / FORMATTING_BENCHMARK_ITERATIONS << " allocations/value";
+    else
+        out << "n/a allocations/value";
+
+    out << " (checksum " << checksum << ")\n";
+    out.flush();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    run(out, "int QString::number", [](int i) { return QString::number(i * 7919); });
+    run(out, "int formatNumber", [](int i) { return formatNumber(i * 7919); });
+
+    run(out, "double QString::number", [](int i) { return QString::number(i * 0.37); });
+    run(out, "double formatNumber", [](int i) { return formatNumber(i * 0.37); });
+
+    run(out, "QRectF QString::arg", [](int i) { return formatRectWithArg(QRectF(i * 0.5, i * 0.25, 640.0, 480.5)); });
+    run(out, "QRectF formatRect", [](int i) { return formatRect(QRectF(i * 0.5, i * 0.25, 640.0, 480.5)); });
+
+    run(out, "QColor QString::arg", [](int i) { return formatColorWithArg(QColor::fromRgb(QRgb(i))); });
+    run(out, "QColor formatColor", [](int i) { return formatColor(QColor::fromRgb(QRgb(i))); });
+
+    run(out, "double QString::toDouble",
+        [](int i)
+        {
+            //
+            return QString::number(QString::number(i * 0.37).toDouble());
+        });
+    run(out, "double parseNumber",
+        [](int i)
+        {
+            double value = 0.0;
+            parseNumber(formatNumber(i * 0.37), value);
+
+            return formatNumber(value);
+        });
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <PropertyGrid.h>
+
+#include <QApplication>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QScrollBar>
+#include <QSize>
+#include <QTextStream>
+#include <QTreeView>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// frames rendered per configuration, the view scrolls by one page per frame and wraps around at the end
+const int PAINT_BENCHMARK_FRAMES_COUNT = 300;
+const int PAINT_BENCHMARK_CATEGORIES_COUNT = 64;
+
+// the data() calls that the view and its delegate made so far, they are only counted with PM_PROPERTY_GRID_ENABLE_STATISTICS
+quint64 dataCallsCount(const PM::PropertyGrid &grid)
+{
+    quint64 result = 0;
+
+    for (const auto &entry : grid.statistics().dataCallsPerRole)
+        result += entry.second;
+
+    return result;
+}
+
+struct Configuration
+{
+    int rowsCount;
+    bool showCategories;
+    QSize viewportSize;
+};
+
+struct FrameStatistics
+{
+    std::vector<qint64> frameTimes; // nanoseconds
+    std::vector<quint64> dataCalls;
+};
+
+void addProperties(PM::PropertyGrid &grid, int count)
+{
+    // a mix of the types that have plain text, decorations and element rows
+    for (int i = 0; i < count; ++i)
+    {
+        const QString name = QString("property %1").arg(i);
+        const PM::CategoryAttribute category(QString("category %1").arg(i % PAINT_BENCHMARK_CATEGORIES_COUNT));
+
+        switch (i % 6)
+        {
+        case 0:
+            grid.addProperty(name, i, category);
+            break;
+
+        case 1:
+            grid.addProperty(name, i * 0.5, category);
+            break;
+
+        case 2:
+            grid.addProperty(name, QString("value %1").arg(i), category, PM::DescriptionAttribute("a string property"));
+            break;
+
+        case 3:
+            grid.addProperty(name, i % 2 == 0, category);
+            break;
+
+        case 4:
+            grid.addProperty(name, QColor::fromHsv(i % 360, 255, 255), category);
+            break;
+
+        default:
+            grid.addProperty(name, QSize(i, i * 2), category);
+            break;
+        }
+    }
+}
+
+qint64 percentile(std::vector<qint64> values, double fraction)
+{
+    if (values.empty())
+        return 0;
+
+    std::sort(values.begin(), values.end());
+
+    // nearest-rank percentile
+    const size_t rank = size_t(std::max(1.0, std::ceil(fraction * double(values.size()))));
+
+    return values[std::min(rank, values.size()) - 1];
+}
+
+FrameStatistics run(const Configuration &configuration)
+{
+    PM::PropertyGrid grid;
+    grid.setAttribute(Qt::WA_DontShowOnScreen);
+    grid.setShowCategories(configuration.showCategories);
+    addProperties(grid, configuration.rowsCount);
+
+    grid.resize(configuration.viewportSize);
+    grid.show();
+
+    QTreeView *treeView = grid.findChild<QTreeView *>();
+
+    treeView->expandAll();
+
+    QImage image(configuration.viewportSize, QImage::Format_ARGB32_Premultiplied);
+    QScrollBar *scrollBar = treeView->verticalScrollBar();
+
+    // the first frame lays the whole view out, it doesn't count
+    QCoreApplication::processEvents();
+    grid.render(&image);
+
+    FrameStatistics result;
+    result.frameTimes.reserve(PAINT_BENCHMARK_FRAMES_COUNT);
+    result.dataCalls.reserve(PAINT_BENCHMARK_FRAMES_COUNT);
+
+    QElapsedTimer timer;
+
+    for (int frame = 0; frame < PAINT_BENCHMARK_FRAMES_COUNT; ++frame)
+    {
+        const quint64 dataCallsBefore = dataCallsCount(grid);
+        const int position = scrollBar->value() + scrollBar->pageStep();
+
+        timer.start();
+
+        scrollBar->setValue(position > scrollBar->maximum() ? scrollBar->minimum() : position);
+        QCoreApplication::processEvents();
+        grid.render(&image);
+
+        result.frameTimes.push_back(timer.nsecsElapsed());
+        result.dataCalls.push_back(dataCallsCount(grid) - dataCallsBefore);
+    }
+
+    return result;
+}
+} // namespace
+
+//
+// Renders a PropertyGrid into a QImage while scrolling through it, run with QT_QPA_PLATFORM=offscreen on headless machines.
+// the data() calls per frame are only counted when the library is built with -DPM_PROPERTY_GRID_ENABLE_STATISTICS=ON
+//
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const bool isCountingDataCalls = PM::PropertyGrid().statistics().isEnabled;
+
+    const std::vector<Configuration> configurations = {
+        {10000, true, QSize(800, 600)},    {10000, false, QSize(800, 600)},    {10000, true, QSize(1920, 1080)},
+        {10000, false, QSize(1920, 1080)}, {100000, true, QSize(800, 600)},    {100000, false, QSize(800, 600)},
+        {100000, true, QSize(1920, 1080)}, {100000, false, QSize(1920, 1080)},
+    };
+
+    out << "rows     mode         viewport    p50 (us)  p95 (us)  p99 (us)  data() calls/frame (p50, max)\n";
+
+    for (const Configuration &configuration : configurations)
+    {
+        const FrameStatistics statistics = run(configuration);
+
+        std::vector<qint64> dataCalls(statistics.dataCalls.begin(), statistics.dataCalls.end());
+
+        out << QString::number(configuration.rowsCount).leftJustified(9);
+        out << QString(configuration.showCategories ? "categorized" : "flat").leftJustified(13);
+        out << QString("%1x%2").arg(configuration.viewportSize.width()).arg(configuration.viewportSize.height()).leftJustified(12);
+        out << QString::number(percentile(statistics.frameTimes, 0.50) / 1000).leftJustified(10);
+        out << QString::number(percentile(statistics.frameTimes, 0.95) / 1000).leftJustified(10);
+        out << QString::number(percentile(statistics.frameTimes, 0.99) / 1000).leftJustified(10);
+
+        if (isCountingDataCalls)
+            out << percentile(dataCalls, 0.50) << ", " << *std::max_element(dataCalls.begin(), dataCalls.end()) << "\n";
+        else
+            out << "n/a\n";
+
+        out.flush();
+    }
+
+    return 0;
+}
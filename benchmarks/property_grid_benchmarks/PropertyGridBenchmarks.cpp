@@ -0,0 +1,303 @@
+#include "PropertyGridBenchmarks.h"
+
+#include <PropertyContext_p.h>
+#include <PropertyGrid.h>
+#include <PropertyGridTreeItem_p.h>
+#include <PropertyGridTreeModel_p.h>
+
+#include <QTest>
+
+#include <utility>
+
+namespace
+{
+const int BENCHMARK_CATEGORIES_COUNT = 16;
+const int BENCHMARK_MODEL_PROPERTIES_COUNT = 10000;
+const int BENCHMARK_GRID_PROPERTIES_COUNT = 1000;
+const int BENCHMARK_FILTER_PROPERTIES_COUNT = 100000;
+const char BENCHMARK_FILTER_TEXT[] = "property 4242";
+
+template <int I>
+struct BenchmarkAttribute : public PM::Attribute
+{
+    QString value = QString("attribute %1").arg(I);
+};
+
+template <int... I>
+PM::Property createPropertyWithAttributes(std::integer_sequence<int, I...>)
+{
+    PM::Property result("property", QMetaType::Int);
+
+    // NOTE: every attribute needs a type of its own, a property holds at most one attribute per type
+    int dummy[] = {0, (result.addAttribute(BenchmarkAttribute<I>()), 0)...};
+    Q_UNUSED(dummy)
+
+    return result;
+}
+
+PM::Property createPropertyWithAttributes(int count)
+{
+    switch (count)
+    {
+    case 1:
+        return createPropertyWithAttributes(std::make_integer_sequence<int, 1>());
+
+    case 4:
+        return createPropertyWithAttributes(std::make_integer_sequence<int, 4>());
+
+    case 16:
+        return createPropertyWithAttributes(std::make_integer_sequence<int, 16>());
+
+    default:
+        return createPropertyWithAttributes(std::make_integer_sequence<int, 0>());
+    }
+}
+
+PM::PropertyList createProperties(int count)
+{
+    PM::PropertyList result;
+    result.reserve(size_t(count));
+
+    for (int i = 0; i < count; ++i)
+    {
+        PM::Property property(QString("property %1").arg(i), QMetaType::Int, PM::DescriptionAttribute(QString("description %1").arg(i)),
+                              PM::CategoryAttribute(QString("category %1").arg(i % BENCHMARK_CATEGORIES_COUNT)));
+
+        result.emplace_back(property, i);
+    }
+
+    return result;
+}
+
+// a model on its own, without any view or grid around it
+void populateModel(PM::internal::PropertyGridTreeModel &model, int count)
+{
+    model.setItemInitializer(
+        [](PM::internal::PropertyGridTreeItem *item)
+        {
+            //
+            item->setColumnData(1, Qt::DisplayRole, item->context.value().toString());
+        });
+
+    std::vector<PM::PropertyContext> contexts;
+    contexts.reserve(size_t(count));
+
+    for (const auto &entry : createProperties(count))
+        contexts.push_back(PM::PropertyContextPrivate::createContext(entry.first, entry.second, nullptr, nullptr));
+
+    model.addProperties(contexts);
+}
+
+QModelIndexList allIndexes(const QAbstractItemModel &model, const QModelIndex &parent = QModelIndex())
+{
+    QModelIndexList result;
+
+    for (int row = 0; row < model.rowCount(parent); ++row)
+    {
+        for (int column = 0; column < model.columnCount(parent); ++column)
+            result.append(model.index(row, column, parent));
+
+        result.append(allIndexes(model, model.index(row, 0, parent)));
+    }
+
+    return result;
+}
+
+class BenchmarkEditorA : public PM::PropertyEditor
+{
+public:
+    bool canHandle(const PM::PropertyContext &context) const override
+    {
+        return false;
+    }
+};
+
+class BenchmarkEditorB : public BenchmarkEditorA
+{
+};
+} // namespace
+
+void PropertyGridBenchmarks::addProperty_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void PropertyGridBenchmarks::addProperty()
+{
+    QFETCH(int, count);
+
+    const PM::PropertyList properties = createProperties(count);
+
+    QBENCHMARK
+    {
+        PM::PropertyGrid grid;
+
+        for (const auto &entry : properties)
+            grid.addProperty(entry.first, entry.second);
+    }
+}
+
+void PropertyGridBenchmarks::modelData_data()
+{
+    QTest::addColumn<int>("role");
+
+    QTest::newRow("DisplayRole") << int(Qt::DisplayRole);
+    QTest::newRow("EditRole") << int(Qt::EditRole);
+    QTest::newRow("DecorationRole") << int(Qt::DecorationRole);
+    QTest::newRow("ToolTipRole") << int(Qt::ToolTipRole);
+    QTest::newRow("FontRole") << int(Qt::FontRole);
+    QTest::newRow("TextAlignmentRole") << int(Qt::TextAlignmentRole);
+    QTest::newRow("BackgroundRole") << int(Qt::BackgroundRole);
+    QTest::newRow("ForegroundRole") << int(Qt::ForegroundRole);
+    QTest::newRow("SizeHintRole") << int(Qt::SizeHintRole);
+}
+
+void PropertyGridBenchmarks::modelData()
+{
+    QFETCH(int, role);
+
+    PM::internal::PropertyGridTreeModel model;
+    populateModel(model, BENCHMARK_MODEL_PROPERTIES_COUNT);
+
+    const QModelIndexList indexes = allIndexes(model);
+
+    QBENCHMARK
+    {
+        for (const QModelIndex &index : indexes)
+            model.data(index, role);
+    }
+}
+
+void PropertyGridBenchmarks::modelIndexAndParent_data()
+{
+    QTest::addColumn<bool>("showCategories");
+
+    QTest::newRow("categorized") << true;
+    QTest::newRow("flat") << false;
+}
+
+void PropertyGridBenchmarks::modelIndexAndParent()
+{
+    QFETCH(bool, showCategories);
+
+    PM::internal::PropertyGridTreeModel model;
+    populateModel(model, BENCHMARK_MODEL_PROPERTIES_COUNT);
+    model.setShowCategories(showCategories);
+
+    QBENCHMARK
+    {
+        for (int row = 0; row < model.rowCount(); ++row)
+        {
+            const QModelIndex topLevelIndex = model.index(row, 0);
+
+            for (int childRow = 0; childRow < model.rowCount(topLevelIndex); ++childRow)
+                model.parent(model.index(childRow, 0, topLevelIndex));
+        }
+    }
+}
+
+void PropertyGridBenchmarks::toggleShowCategories()
+{
+    PM::internal::PropertyGridTreeModel model;
+    populateModel(model, BENCHMARK_MODEL_PROPERTIES_COUNT);
+
+    QBENCHMARK
+    {
+        model.setShowCategories(false);
+        model.setShowCategories(true);
+    }
+}
+
+void PropertyGridBenchmarks::setFilterText_data()
+{
+    QTest::addColumn<bool>("showCategories");
+    QTest::addColumn<int>("sortMode");
+
+    QTest::newRow("categorized") << true << int(PM::PropertyGrid::SortMode::InsertionOrder);
+    QTest::newRow("categorized, by name") << true << int(PM::PropertyGrid::SortMode::NameOrder);
+    QTest::newRow("flat") << false << int(PM::PropertyGrid::SortMode::InsertionOrder);
+    QTest::newRow("flat, by name") << false << int(PM::PropertyGrid::SortMode::NameOrder);
+}
+
+void PropertyGridBenchmarks::setFilterText()
+{
+    QFETCH(bool, showCategories);
+    QFETCH(int, sortMode);
+
+    PM::internal::PropertyGridTreeModel model;
+    populateModel(model, BENCHMARK_FILTER_PROPERTIES_COUNT);
+    model.setShowCategories(showCategories);
+    model.setSortMode(PM::PropertyGrid::SortMode(sortMode));
+
+    const QString text = QString::fromLatin1(BENCHMARK_FILTER_TEXT);
+
+    // NOTE: typed one character at a time, so most of the queries narrow down the previous one, then cleared at once
+    QBENCHMARK
+    {
+        for (int length = 1; length <= text.size(); ++length)
+            model.setFilterText(text.left(length));
+
+        model.setFilterText(QString());
+    }
+}
+
+void PropertyGridBenchmarks::setPropertyValue()
+{
+    PM::PropertyGrid grid;
+
+    const PM::PropertyList properties = createProperties(BENCHMARK_GRID_PROPERTIES_COUNT);
+    for (const auto &entry : properties)
+        grid.addProperty(entry.first, entry.second);
+
+    int value = 0;
+
+    QBENCHMARK
+    {
+        for (const auto &entry : properties)
+            grid.setPropertyValue(entry.first.name(), ++value);
+    }
+}
+
+void PropertyGridBenchmarks::addPropertyEditor()
+{
+    PM::PropertyGrid grid;
+
+    for (const auto &entry : createProperties(BENCHMARK_GRID_PROPERTIES_COUNT))
+        grid.addProperty(entry.first, entry.second);
+
+    grid.addPropertyEditor<BenchmarkEditorA>();
+
+    // NOTE: adding an editor that is already there is a no-op, swapping two of them re-evaluates every property twice
+    QBENCHMARK
+    {
+        grid.replacePropertyEditor<BenchmarkEditorA, BenchmarkEditorB>();
+        grid.replacePropertyEditor<BenchmarkEditorB, BenchmarkEditorA>();
+    }
+}
+
+void PropertyGridBenchmarks::copyProperty_data()
+{
+    QTest::addColumn<int>("attributesCount");
+
+    QTest::newRow("0 attributes") << 0;
+    QTest::newRow("1 attribute") << 1;
+    QTest::newRow("4 attributes") << 4;
+    QTest::newRow("16 attributes") << 16;
+}
+
+void PropertyGridBenchmarks::copyProperty()
+{
+    QFETCH(int, attributesCount);
+
+    const PM::Property property = createPropertyWithAttributes(attributesCount);
+
+    QBENCHMARK
+    {
+        PM::Property copy(property);
+        Q_UNUSED(copy)
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef PROPERTYGRIDBENCHMARKS_H
+#define PROPERTYGRIDBENCHMARKS_H
+
+#include <QObject>
+
+class PropertyGridBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addProperty_data();
+    void addProperty();
+
+    void modelData_data();
+    void modelData();
+
+    void modelIndexAndParent_data();
+    void modelIndexAndParent();
+
+    void toggleShowCategories();
+
+    void setFilterText_data();
+    void setFilterText();
+
+    void setPropertyValue();
+
+    void addPropertyEditor();
+
+    void copyProperty_data();
+    void copyProperty();
+};
+
+#endif // PROPERTYGRIDBENCHMARKS_H
@@ -0,0 +1,132 @@
+#include "PropertyGridBenchmarks.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <QTextStream>
+
+namespace
+{
+const char BENCHMARKS_JSON_OPTION[] = "--json";
+
+// splits a line of QtTest's CSV output, the names are quoted and the numbers aren't
+QStringList splitCsvLine(const QString &line)
+{
+    QStringList result;
+    QString field;
+    bool isQuoted = false;
+
+    for (int i = 0; i < line.size(); ++i)
+    {
+        const QChar character = line.at(i);
+
+        if (character == QLatin1Char('"'))
+        {
+            // doubled quotes are escaped ones
+            if (isQuoted && i + 1 < line.size() && line.at(i + 1) == QLatin1Char('"'))
+                field.append(line.at(++i));
+            else
+                isQuoted = !isQuoted;
+        }
+        else if (character == QLatin1Char(',') && !isQuoted)
+        {
+            result.append(field);
+            field.clear();
+        }
+        else
+        {
+            field.append(character);
+        }
+    }
+
+    result.append(field);
+
+    return result;
+}
+
+// every line is: "function","data tag","metric",value per iteration,total,iterations
+QJsonArray readCsvResults(const QString &fileName)
+{
+    QJsonArray result;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return result;
+
+    QTextStream stream(&file);
+    while (!stream.atEnd())
+    {
+        const QStringList fields = splitCsvLine(stream.readLine());
+
+        if (fields.size() < 6)
+            continue;
+
+        QJsonObject entry;
+        entry.insert("name", fields.at(0));
+        entry.insert("tag", fields.at(1));
+        entry.insert("metric", fields.at(2));
+        entry.insert("value", fields.at(3).toDouble());
+        entry.insert("total", fields.at(4).toDouble());
+        entry.insert("iterations", fields.at(5).toLongLong());
+
+        result.append(entry);
+    }
+
+    return result;
+}
+} // namespace
+
+//
+// Runs the benchmarks like any other QtTest executable, e.g. with QT_QPA_PLATFORM=offscreen on headless machines.
+// `--json <file>` additionally writes the results in a machine-readable form, to track them between releases.
+//
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString jsonFileName;
+
+    const int jsonOptionIndex = arguments.indexOf(BENCHMARKS_JSON_OPTION);
+    if (jsonOptionIndex >= 0 && jsonOptionIndex + 1 < arguments.size())
+    {
+        jsonFileName = arguments.at(jsonOptionIndex + 1);
+        arguments.erase(arguments.begin() + jsonOptionIndex, arguments.begin() + jsonOptionIndex + 2);
+    }
+
+    // NOTE: QtTest has no JSON logger, the results get written as CSV next to the regular output and converted afterwards
+    const QString csvFileName = QDir::temp().filePath(QString("PmPropertyGridBenchmarks-%1.csv").arg(QCoreApplication::applicationPid()));
+
+    if (!jsonFileName.isEmpty())
+        arguments << "-o" << "-,txt" << "-o" << csvFileName + ",csv";
+
+    PropertyGridBenchmarks benchmarks;
+    const int result = QTest::qExec(&benchmarks, arguments);
+
+    if (jsonFileName.isEmpty())
+        return result;
+
+    QJsonObject report;
+    report.insert("qtVersion", QString(qVersion()));
+    report.insert("timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    report.insert("results", readCsvResults(csvFileName));
+
+    QFile::remove(csvFileName);
+
+    QFile jsonFile(jsonFileName);
+    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "can't write" << jsonFileName << ":" << jsonFile.errorString();
+        return result != 0 ? result : 1;
+    }
+
+    jsonFile.write(QJsonDocument(report).toJson());
+
+    return result;
+}
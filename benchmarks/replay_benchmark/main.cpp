@@ -0,0 +1,158 @@
+#include <PropertyGrid.h>
+#include <PropertyGridSession.h>
+
+#include <QApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QTextStream>
+
+#include <map>
+
+namespace
+{
+const char *recordTypeName(PM::PropertyGridReplayer::RecordType type)
+{
+    switch (type)
+    {
+    case PM::PropertyGridReplayer::AddProperty:
+        return "add property";
+    case PM::PropertyGridReplayer::SetValue:
+        return "set value";
+    case PM::PropertyGridReplayer::Edit:
+        return "edit";
+    case PM::PropertyGridReplayer::ShowCategories:
+        return "show categories";
+    case PM::PropertyGridReplayer::Clear:
+        return "clear";
+    case PM::PropertyGridReplayer::CurrentChanged:
+        return "current changed";
+    case PM::PropertyGridReplayer::Scroll:
+        return "scroll";
+    }
+
+    return "unknown";
+}
+
+struct RecordTimings
+{
+    quint64 count = 0;
+    qint64 totalNanoseconds = 0;
+    qint64 maxNanoseconds = 0;
+};
+} // namespace
+
+//
+// Replays a session recorded with PropertyGridRecorder into a fresh grid as fast as possible and reports the time spent
+// per record type, run with QT_QPA_PLATFORM=offscreen on headless machines.
+//
+// usage: replay_benchmark <session log> [--iterations N] [--paint]
+//   --paint  lets the event loop run and renders the grid after every scroll record
+//
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList arguments = app.arguments();
+    if (arguments.size() < 2)
+    {
+        err << "usage: replay_benchmark <session log> [--iterations N] [--paint]\n";
+        return 1;
+    }
+
+    int iterationsCount = 10;
+    const int iterationsIndex = arguments.indexOf("--iterations");
+    if (iterationsIndex >= 0 && iterationsIndex + 1 < arguments.size())
+        iterationsCount = qMax(1, arguments[iterationsIndex + 1].toInt());
+
+    const bool paint = arguments.contains("--paint");
+
+    // the log is read once, the replays shouldn't measure the disk
+    QFile file(arguments[1]);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err << "cannot open " << file.fileName() << ": " << file.errorString() << "\n";
+        return 1;
+    }
+
+    const QByteArray log = file.readAll();
+
+    std::map<PM::PropertyGridReplayer::RecordType, RecordTimings> timings;
+    qint64 totalNanoseconds = 0;
+
+    QElapsedTimer timer;
+
+    for (int iteration = 0; iteration < iterationsCount; ++iteration)
+    {
+        PM::PropertyGrid grid;
+        grid.setAttribute(Qt::WA_DontShowOnScreen);
+        grid.resize(800, 600);
+        grid.show();
+
+        QImage image(grid.size(), QImage::Format_ARGB32_Premultiplied);
+
+        QBuffer buffer;
+        buffer.setData(log);
+        buffer.open(QIODevice::ReadOnly);
+
+        PM::PropertyGridReplayer replayer(&grid);
+
+        QString errorMessage;
+        if (!replayer.open(&buffer, &errorMessage))
+        {
+            err << arguments[1] << ": " << errorMessage << "\n";
+            return 1;
+        }
+
+        PM::PropertyGridReplayer::RecordType type;
+
+        while (true)
+        {
+            timer.start();
+
+            if (!replayer.replayNext(&type))
+                break;
+
+            if (paint && type == PM::PropertyGridReplayer::Scroll)
+            {
+                QCoreApplication::processEvents();
+                grid.render(&image);
+            }
+
+            const qint64 elapsed = timer.nsecsElapsed();
+
+            RecordTimings &recordTimings = timings[type];
+            ++recordTimings.count;
+            recordTimings.totalNanoseconds += elapsed;
+            recordTimings.maxNanoseconds = qMax(recordTimings.maxNanoseconds, elapsed);
+
+            totalNanoseconds += elapsed;
+        }
+
+        if (!replayer.errorString().isEmpty())
+        {
+            err << arguments[1] << ": " << replayer.errorString() << "\n";
+            return 1;
+        }
+    }
+
+    out << "record           count     total (ms)  mean (us)  max (us)\n";
+
+    for (const auto &entry : timings)
+    {
+        const RecordTimings &recordTimings = entry.second;
+
+        out << QString(recordTypeName(entry.first)).leftJustified(17);
+        out << QString::number(recordTimings.count / quint64(iterationsCount)).leftJustified(10);
+        out << QString::number(double(recordTimings.totalNanoseconds) / iterationsCount / 1e6, 'f', 3).leftJustified(12);
+        out << QString::number(double(recordTimings.totalNanoseconds) / double(recordTimings.count) / 1e3, 'f', 1).leftJustified(11);
+        out << QString::number(double(recordTimings.maxNanoseconds) / 1e3, 'f', 1) << "\n";
+    }
+
+    out << "\ntotal per replay: " << QString::number(double(totalNanoseconds) / iterationsCount / 1e6, 'f', 3) << " ms\n";
+
+    return 0;
+}
@@ -99,6 +99,7 @@ QObject *ObjectPropertyGrid::selectedObject() const
 
 void ObjectPropertyGrid::updateProperties()
 {
+    // NOTE: this also cancels the population of the previous selection if it's still in progress
     clearProperties();
 
     for (const auto &connection : qAsConst(m_objectsConnections))
@@ -108,19 +109,30 @@ void ObjectPropertyGrid::updateProperties()
     if (m_objects.isEmpty())
         return;
 
+    // make sure to propagate properties values that are changed in the UI to the underlying objects
+    m_objectsConnections << connect(this, &PM::PropertyGrid::propertyValueChanged, this,
+                                    [this](const PM::PropertyContext &context)
+                                    {
+                                        for (QObject *obj : qAsConst(m_objects))
+                                            obj->setProperty(context.property().name().toUtf8().constData(), context.value());
+                                    });
+
+    // reading the values requires access to the objects, so the properties are added on the GUI thread in small slices
     const QList<QMetaProperty> commonProperties = getCommonProperties(m_objects);
-    for (const QMetaProperty &metaProperty : commonProperties)
-    {
-        const PM::Property gridProperty = createGridProperty(metaProperty);
-        const QVariant propertyValue = getMergedPropertyValue(m_objects, metaProperty);
-        addProperty(gridProperty, propertyValue);
-
-        // make sure to propagate properties values that are changed in the UI to the underlying objects
-        m_objectsConnections << connect(this, &PM::PropertyGrid::propertyValueChanged, this,
-                                        [this](const PM::PropertyContext &context)
-                                        {
-                                            for (QObject *obj : qAsConst(m_objects))
-                                                obj->setProperty(context.property().name().toUtf8().constData(), context.value());
-                                        });
-    }
+    const QObjectList objects = m_objects;
+    int nextPropertyIndex = 0;
+
+    populateProperties(
+        [commonProperties, objects, nextPropertyIndex](PM::Property &property, QVariant &value) mutable
+        {
+            if (nextPropertyIndex >= commonProperties.size())
+                return false;
+
+            const QMetaProperty &metaProperty = commonProperties.at(nextPropertyIndex++);
+
+            property = createGridProperty(metaProperty);
+            value = getMergedPropertyValue(objects, metaProperty);
+
+            return true;
+        });
 }
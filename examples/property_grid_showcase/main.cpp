@@ -1,4 +1,6 @@
+#include <PropertyBlob.h>
 #include <PropertyGrid.h>
+#include <PropertyGridSession.h>
 
 #include <QtCompat_p.h>
 
@@ -8,9 +10,11 @@
 #include <QDate>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QHeaderView>
 #include <QKeySequence>
 #include <QLayout>
+#include <QLineEdit>
 #include <QMatrix4x4>
 #include <QVector2D>
 #include <QVector3D>
@@ -47,6 +51,13 @@ int main(int argc, char **argv)
 
     PM::PropertyGrid propertyGrid;
 
+    // PM_PROPERTY_GRID_SESSION_LOG=<path> records the session, replay it with benchmarks/replay_benchmark
+    QFile sessionLog(QString::fromLocal8Bit(qgetenv("PM_PROPERTY_GRID_SESSION_LOG")));
+    std::unique_ptr<PM::PropertyGridRecorder> sessionRecorder;
+
+    if (!sessionLog.fileName().isEmpty() && sessionLog.open(QIODevice::WriteOnly))
+        sessionRecorder = std::make_unique<PM::PropertyGridRecorder>(&propertyGrid, &sessionLog);
+
     // add properties
     addProperty(propertyGrid, "Property1", "Value1", "Description of property1");
     addProperty(propertyGrid, "text", "The quick brown fox jumps over the lazy dog", "the text to be displayed in the UI");
@@ -119,6 +130,8 @@ int main(int argc, char **argv)
     addProperty(propertyGrid, "pixmap (QPixmap property)", QPixmap(":/icons/preferences-svgrepo-com.svg"));
     addProperty(propertyGrid, "bitmap (QBitmap property)", QBitmap("C:/Users/hp/Downloads/ProbeMaestro_icon.png"));
     addProperty(propertyGrid, "image (QImage property)", QImage("C:/Users/hp/Downloads/ProbeMaestro_icon.png"));
+    addProperty(propertyGrid, "executable (PM::PropertyBlob property)",
+                QVariant::fromValue(PM::PropertyBlob::fromFile(QCoreApplication::applicationFilePath())));
     // Simple properties
     propertyGrid.addProperty("default color (no-attributes property)", QColor(Qt::green));
     propertyGrid.addProperty("current color (Read-only property)", QColor(Qt::blue), PM::ReadOnlyAttribute());
@@ -144,6 +157,19 @@ int main(int argc, char **argv)
 
     propertyGrid.layout()->addWidget(&checkbox);
 
+    QLineEdit filterEdit(&propertyGrid);
+    filterEdit.setPlaceholderText("filter");
+    filterEdit.setClearButtonEnabled(true);
+
+    QObject::connect(&filterEdit, &QLineEdit::textChanged, &propertyGrid,
+                     [&](const QString &text)
+                     {
+                         //
+                         propertyGrid.setFilterText(text);
+                     });
+
+    propertyGrid.layout()->addWidget(&filterEdit);
+
     QObject::connect(&propertyGrid, &PM::PropertyGrid::propertyValueChanged, &propertyGrid,
                      [](const PM::PropertyContext &context)
                      {
@@ -49,7 +49,12 @@ void Property::setAttributesFromOther(const Property &other)
 
     for (const auto &pair : other.m_attributes)
     {
-        const AttributesFunctionHelper &helper = Property::s_attributesRegistry[pair.first];
+        // NOTE: a lookup (rather than operator[]) keeps copying read-only, properties get copied on worker threads too
+        const auto helperIt = Property::s_attributesRegistry.find(pair.first);
+        if (helperIt == Property::s_attributesRegistry.end())
+            continue;
+
+        const AttributesFunctionHelper &helper = helperIt->second;
 
         if (helper.copyFunc == nullptr || helper.deleteFunc == nullptr)
             continue;
@@ -66,3 +71,20 @@ const Attribute *Property::getAttribute_impl(TypeId typeUid) const
 
     return nullptr;
 }
+
+size_t internal::attributesMemoryUsage(const Property &property)
+{
+    // a node of the map per attribute (the key, the pointer along with its deleter and the link), plus the buckets
+    size_t result = property.m_attributes.bucket_count() * sizeof(void *);
+
+    for (const auto &pair : property.m_attributes)
+    {
+        result += sizeof(pair) + sizeof(void *);
+
+        const auto helperIt = Property::s_attributesRegistry.find(pair.first);
+        if (helperIt != Property::s_attributesRegistry.end())
+            result += helperIt->second.size;
+    }
+
+    return result;
+}
@@ -3,8 +3,10 @@
 
 #include "TemplateParameterChecks.h"
 
+#include <QStringList>
 #include <QVariant>
 
+#include <functional>
 #include <memory>
 #include <typeindex>
 
@@ -27,6 +29,8 @@ namespace internal
         CreateFunc createFunc;
         CopyFunc copyFunc;
         DeleteFunc deleteFunc;
+
+        size_t size = 0; // sizeof the attribute, for the memory estimates
     };
 
     using AttributePtr = std::unique_ptr<Attribute, AttributesFunctionHelper::DeleteFunc>;
@@ -52,6 +56,11 @@ namespace internal
     bool isRegisteredAttribute();
 
     bool isReadOnly(const Property &property);
+    // false for properties without a DefaultValueAttribute
+    bool isDefaultValue(const Property &property, const QVariant &value);
+
+    // what the attributes of a property take on the heap, only the attributes themselves (not the data they point to)
+    size_t attributesMemoryUsage(const Property &property);
 } // namespace internal
 
 struct Attribute
@@ -115,6 +124,8 @@ private:
     template <typename T>
     friend bool internal::isRegisteredAttribute();
 
+    friend size_t internal::attributesMemoryUsage(const Property &property);
+
 private:
     int m_type;
     QString m_name;
@@ -150,6 +161,7 @@ struct DefaultValueAttribute : public Attribute
     QVariant value;
 };
 
+// "/" separated paths give nested categories, e.g. "Rendering/Shadows"
 struct CategoryAttribute : public Attribute
 {
     CategoryAttribute() = default;
@@ -173,6 +185,31 @@ struct ReadOnlyAttribute : public Attribute
 
     bool value;
 };
+
+// Computes the value, the read-only state and/or the visibility of a property out of the values of other properties.
+// Every function gets the current values of the dependencies, in the order they are listed. the ones left empty are not
+// computed. Dependents are recomputed automatically whenever one of their dependencies changes.
+struct DependsOnAttribute : public Attribute
+{
+    using ValueFunction = std::function<QVariant(const QVariantList &values)>;
+    using StateFunction = std::function<bool(const QVariantList &values)>;
+
+    DependsOnAttribute() = default;
+
+    inline explicit DependsOnAttribute(const QStringList &dependencies, const ValueFunction &value = ValueFunction(),
+                                       const StateFunction &isReadOnly = StateFunction(), const StateFunction &isVisible = StateFunction()) :
+        dependencies(dependencies),
+        value(value),
+        isReadOnly(isReadOnly),
+        isVisible(isVisible)
+    {
+    }
+
+    QStringList dependencies;
+    ValueFunction value;
+    StateFunction isReadOnly;
+    StateFunction isVisible;
+};
 } // namespace PM
 
 template <typename T, typename>
@@ -244,6 +281,7 @@ inline void PM::internal::registerAttribute()
     helper.createFunc = []() { return std::make_unique<DecayedT>(); };
     helper.copyFunc = [](const Attribute &attr) { return std::make_unique<DecayedT>(static_cast<const DecayedT &>(attr)); };
     helper.deleteFunc = [](Attribute *p) { delete static_cast<DecayedT *>(p); };
+    helper.size = sizeof(DecayedT);
 
     Property::s_attributesRegistry[PM::internal::getTypeId<DecayedT>()] = helper;
 }
@@ -261,4 +299,9 @@ inline bool PM::internal::isReadOnly(const Property &property)
     return property.hasAttribute<PM::ReadOnlyAttribute>() && property.getAttribute<PM::ReadOnlyAttribute>().value == true;
 }
 
+inline bool PM::internal::isDefaultValue(const Property &property, const QVariant &value)
+{
+    return property.hasAttribute<PM::DefaultValueAttribute>() && property.getAttribute<PM::DefaultValueAttribute>().value == value;
+}
+
 #endif // PROPERTY_H
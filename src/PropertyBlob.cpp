@@ -0,0 +1,140 @@
+#include "PropertyBlob.h"
+
+#include <QDebug>
+#include <QFile>
+
+#include <limits>
+#include <utility>
+
+using namespace PM;
+
+struct PropertyBlob::Data
+{
+    QByteArray bytes;
+
+    // NOTE: the mapping lives as long as the file object does
+    std::unique_ptr<QFile> file;
+    const char *mappedData = nullptr;
+    qint64 mappedOffset = 0;
+
+    const char *constData() const
+    {
+        return file != nullptr ? mappedData : bytes.constData();
+    }
+};
+
+PropertyBlob::PropertyBlob() : m_offset(0), m_size(0)
+{
+}
+
+PropertyBlob::PropertyBlob(const QByteArray &data) : m_offset(0), m_size(data.size())
+{
+    auto blobData = std::make_shared<Data>();
+    blobData->bytes = data;
+
+    m_data = std::move(blobData);
+}
+
+PropertyBlob PropertyBlob::fromFile(const QString &fileName, qint64 offset, qint64 size)
+{
+    auto file = std::make_unique<QFile>(fileName);
+
+    if (!file->open(QIODevice::ReadOnly))
+    {
+        qWarning() << "can't open" << fileName << ":" << file->errorString();
+        return PropertyBlob();
+    }
+
+    if (offset < 0 || offset > file->size())
+        return PropertyBlob();
+
+    // NOTE: compared against what is left of the file, `offset + size` could overflow
+    if (size < 0 || size > file->size() - offset)
+        size = file->size() - offset;
+
+    auto blobData = std::make_shared<Data>();
+
+    // NOTE: empty regions can't be mapped, an empty blob doesn't need any data anyway
+    if (size > 0)
+    {
+        blobData->mappedData = reinterpret_cast<const char *>(file->map(offset, size));
+
+        if (blobData->mappedData == nullptr)
+        {
+            qWarning() << "can't map" << fileName << ":" << file->errorString();
+            return PropertyBlob();
+        }
+    }
+
+    blobData->file = std::move(file);
+    blobData->mappedOffset = offset;
+
+    PropertyBlob result;
+    result.m_data = std::move(blobData);
+    result.m_size = size;
+
+    return result;
+}
+
+bool PropertyBlob::isNull() const
+{
+    return m_data == nullptr;
+}
+
+qint64 PropertyBlob::size() const
+{
+    return m_size;
+}
+
+QString PropertyBlob::fileName() const
+{
+    return m_data != nullptr && m_data->file != nullptr ? m_data->file->fileName() : QString();
+}
+
+qint64 PropertyBlob::offset() const
+{
+    return m_data != nullptr ? m_data->mappedOffset + m_offset : 0;
+}
+
+const char *PropertyBlob::constData() const
+{
+    return m_data != nullptr ? m_data->constData() + m_offset : nullptr;
+}
+
+PropertyBlob PropertyBlob::slice(qint64 position, qint64 length) const
+{
+    position = qBound<qint64>(0, position, m_size);
+
+    if (length < 0 || length > m_size - position)
+        length = m_size - position;
+
+    PropertyBlob result = *this;
+    result.m_offset += position;
+    result.m_size = length;
+
+    return result;
+}
+
+QByteArray PropertyBlob::toByteArray() const
+{
+    // Qt 5 byte arrays are limited to int sizes
+    using ByteArraySize = decltype(std::declval<QByteArray>().size());
+
+    if (m_size > qint64(std::numeric_limits<ByteArraySize>::max()))
+    {
+        qWarning() << "a blob of" << m_size << "bytes doesn't fit into a QByteArray";
+        return QByteArray();
+    }
+
+    return QByteArray(constData(), ByteArraySize(m_size));
+}
+
+bool PropertyBlob::operator==(const PropertyBlob &other) const
+{
+    return m_data == other.m_data && m_offset == other.m_offset && m_size == other.m_size;
+}
+
+bool PropertyBlob::operator!=(const PropertyBlob &other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,56 @@
+#ifndef PROPERTYBLOB_H
+#define PROPERTYBLOB_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+
+#include <memory>
+
+namespace PM
+{
+//
+// Binary data that is shown as a paged hex view instead of being converted to text as a whole.
+// The data either lives in a QByteArray or in a memory-mapped region of a file, in which case only the pages
+// that actually get displayed are ever loaded. Copies and slices share the same data.
+//
+// Blobs are read-only in the property grid.
+//
+class PropertyBlob
+{
+public:
+    PropertyBlob();
+    explicit PropertyBlob(const QByteArray &data);
+
+    // maps `size` bytes of the file starting at `offset` (everything up to the end of the file for -1).
+    // returns a null blob if the file can't be opened or mapped
+    static PropertyBlob fromFile(const QString &fileName, qint64 offset = 0, qint64 size = -1);
+
+    bool isNull() const;
+    qint64 size() const;
+
+    QString fileName() const; // empty for blobs that aren't mapped from a file
+    qint64 offset() const;    // of this blob in the file or the byte array it was created from
+
+    const char *constData() const;
+
+    // NOTE: slices share the data of this blob, nothing gets copied
+    PropertyBlob slice(qint64 position, qint64 length = -1) const;
+    QByteArray toByteArray() const; // a deep copy, avoid this for mapped files. empty if the blob doesn't fit into a QByteArray
+
+    // NOTE: blobs are equal when they refer to the same region of the same data, the bytes themselves are never compared
+    bool operator==(const PropertyBlob &other) const;
+    bool operator!=(const PropertyBlob &other) const;
+
+private:
+    struct Data;
+
+    std::shared_ptr<const Data> m_data;
+    qint64 m_offset;
+    qint64 m_size;
+};
+} // namespace PM
+
+Q_DECLARE_METATYPE(PM::PropertyBlob)
+
+#endif // PROPERTYBLOB_H
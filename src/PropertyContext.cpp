@@ -45,6 +45,11 @@ void PropertyContextPrivate::setValue(PropertyContext &context, const QVariant &
     notifyValueChanged(context, value);
 }
 
+void PropertyContextPrivate::setPropertyGrid(PropertyContext &context, PropertyGrid *propertyGrid)
+{
+    context.m_propertyGrid = propertyGrid;
+}
+
 PropertyContextPrivate::valueChangedSlot_t PropertyContextPrivate::defaultValueChangedSlot()
 {
     static valueChangedSlot_t result = [](const QVariant &) {};
@@ -67,7 +72,7 @@ void PropertyContextPrivate::notifyValueChanged(const PropertyContext &context,
     context.m_valueChangedSlot(newValue);
 }
 
-Property PropertyContext::property() const
+const Property &PropertyContext::property() const
 {
     return m_property;
 }
@@ -15,7 +15,7 @@ class PropertyContext
     friend class PM::PropertyContextPrivate;
 
 public:
-    Property property() const;
+    const Property &property() const;
     QVariant value() const;
 
     bool isValid() const;
@@ -29,6 +29,7 @@ public:
     static PropertyContext createContext(const Property &property, const QVariant &value, void *object, PropertyGrid *propertyGrid);
 
     static void setValue(PropertyContext &context, const QVariant &value);
+    static void setPropertyGrid(PropertyContext &context, PropertyGrid *propertyGrid);
 
     static valueChangedSlot_t defaultValueChangedSlot();
 
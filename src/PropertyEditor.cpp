@@ -1,6 +1,8 @@
 #include "PropertyEditor.h"
 
 #include "PropertyContext_p.h"
+#include "PropertyEditorFontCache_p.h"
+#include "PropertyEditorFormatting_p.h"
 #include "QtCompat_p.h"
 
 #include <QApplication>
@@ -58,12 +60,136 @@ const PropertyEditorsMap_t &PM::internal::defaultPropertyEditors()
         createPropertyEditorMapEntry<ImagesPropertyEditor>(),
         createPropertyEditorMapEntry<CursorPropertyEditor>(),
         createPropertyEditorMapEntry<BoolPropertyEditor>(),
+        createPropertyEditorMapEntry<BlobPropertyEditor>(),
     };
     // clang-format on
 
     return instance;
 }
 
+PropertyEditor *PM::internal::findPropertyEditor(const PropertyEditorsMap_t &editors, const PropertyContext &context)
+{
+    for (auto editor = editors.begin(); editor != editors.end(); ++editor)
+    {
+        if (editor->second->canHandle(context))
+            return editor->second.get();
+    }
+
+    return nullptr;
+}
+
+DropDownListModel::DropDownListModel(int count, const ValueFunction &valueFunction, const TextFunction &textFunction, QObject *parent) :
+    QAbstractListModel(parent),
+    m_count(count),
+    m_valueFunction(valueFunction),
+    m_textFunction(textFunction),
+    m_texts(size_t(count))
+{
+}
+
+DropDownListModel::DropDownListModel(const QVariantList &values, QObject *parent) :
+    DropDownListModel(
+        int(values.size()),
+        [values](int row)
+        {
+            //
+            return values.at(row);
+        },
+        TextFunction(), parent)
+{
+}
+
+int DropDownListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant DropDownListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count)
+        return QVariant();
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return text(index.row());
+
+    case Qt::DecorationRole:
+        return m_decorationFunction ? m_decorationFunction(value(index.row())) : QVariant();
+
+    case Qt::UserRole:
+        return value(index.row());
+
+    default:
+        return QVariant();
+    }
+}
+
+QVariant DropDownListModel::value(int row) const
+{
+    return m_valueFunction(row);
+}
+
+QString DropDownListModel::text(int row) const
+{
+    QString &result = m_texts[size_t(row)];
+
+    if (result.isNull())
+    {
+        const QVariant rowValue = value(row);
+        result = m_textFunction ? m_textFunction(rowValue) : rowValue.toString();
+
+        // NOTE: an empty text is cached as well, only the null string means "not generated yet"
+        if (result.isNull())
+            result = QLatin1String("");
+    }
+
+    return result;
+}
+
+int DropDownListModel::findValue(const QVariant &value, int hintRow) const
+{
+    if (hintRow >= 0 && hintRow < m_count && this->value(hintRow) == value)
+        return hintRow;
+
+    for (int row = 0; row < m_count; ++row)
+    {
+        if (row != hintRow && this->value(row) == value)
+            return row;
+    }
+
+    return -1;
+}
+
+bool DropDownListModel::hasTextFunction() const
+{
+    return bool(m_textFunction);
+}
+
+void DropDownListModel::setTextFunction(const TextFunction &textFunction)
+{
+    beginResetModel();
+    m_textFunction = textFunction;
+    std::fill(m_texts.begin(), m_texts.end(), QString());
+    endResetModel();
+}
+
+void DropDownListModel::setDecorationFunction(const DecorationFunction &decorationFunction)
+{
+    beginResetModel();
+    m_decorationFunction = decorationFunction;
+    endResetModel();
+}
+
+void DropDownListModel::setRowCount(int count)
+{
+    beginResetModel();
+    m_count = count;
+    m_texts.assign(size_t(count), QString());
+    endResetModel();
+}
+
 bool PropertyEditor::canHandle(const PropertyContext &context) const
 {
     return true;
@@ -79,10 +205,10 @@ QString PropertyEditor::toString(const PropertyContext &context) const
         return value.toString();
 
     case qMetaTypeId<int>():
-        return QString::number(value.toInt());
+        return PM::internal::formatNumber(value.toInt());
 
     case qMetaTypeId<double>():
-        return QString::number(value.toDouble());
+        return PM::internal::formatNumber(value.toDouble());
 
     case qMetaTypeId<bool>():
         return value.toBool() ? PROPERTY_EDITOR_TRUE_STRING : PROPERTY_EDITOR_FALSE_STRING;
@@ -91,16 +217,16 @@ QString PropertyEditor::toString(const PropertyContext &context) const
         return QString(value.toChar());
 
     case qMetaTypeId<std::uint32_t>():
-        return QString::number(value.toUInt());
+        return PM::internal::formatNumber(value.toUInt());
 
     case qMetaTypeId<std::int64_t>():
-        return QString::number(value.toLongLong());
+        return PM::internal::formatNumber(value.toLongLong());
 
     case qMetaTypeId<std::uint64_t>():
-        return QString::number(value.toULongLong());
+        return PM::internal::formatNumber(value.toULongLong());
 
     case qMetaTypeId<QDate>():
-        return value.toDate().toString(Qt::ISODate);
+        return PM::internal::formatDate(value.toDate());
 
     case qMetaTypeId<QTime>():
         return value.toTime().toString(Qt::ISODate);
@@ -119,12 +245,20 @@ QString PropertyEditor::toString(const PropertyContext &context) const
 
     case qMetaTypeId<QBitArray>():
     {
-        QByteArray byteArray;
+        // NOTE: the bits are packed the same way fromString() unpacks them, the least significant bit of each byte first
+        const QBitArray bitArray = value.toBitArray();
+        QByteArray byteArray((bitArray.size() + 7) / 8, '\0');
+
+        for (int i = 0; i < bitArray.size(); ++i)
+        {
+            if (bitArray.testBit(i))
+                byteArray[i / 8] = char(byteArray.at(i / 8) | (1 << (i % 8)));
+        }
 
-        for (int i = 0; i < value.toBitArray().size(); ++i)
-            byteArray.append(value.toBitArray().testBit(i) ? '1' : '0');
+        QByteArray result(byteArray.size() * 2, Qt::Uninitialized);
+        PM::internal::encodeHex(byteArray.constData(), byteArray.size(), result.data());
 
-        return QString::fromUtf8(byteArray.toHex());
+        return QString::fromLatin1(result);
     }
 
     default:
@@ -138,7 +272,6 @@ QVariant PropertyEditor::fromString(const QString &value, const PropertyContext
 {
     static const char errorMessageTemplate[] = "%1 is not a valid value for %2.";
 
-    bool _ok;
     switch (context.property().type())
     {
     case qMetaTypeId<QString>():
@@ -146,9 +279,9 @@ QVariant PropertyEditor::fromString(const QString &value, const PropertyContext
 
     case qMetaTypeId<int>():
     {
-        int intValue = value.toInt(&_ok);
+        int intValue = 0;
 
-        if (!_ok)
+        if (!PM::internal::parseNumber(value, intValue))
             break;
 
         return intValue;
@@ -156,9 +289,9 @@ QVariant PropertyEditor::fromString(const QString &value, const PropertyContext
 
     case qMetaTypeId<double>():
     {
-        double doubleValue = value.toDouble(&_ok);
+        double doubleValue = 0.0;
 
-        if (!_ok)
+        if (!PM::internal::parseNumber(value, doubleValue))
             break;
 
         return doubleValue;
@@ -181,37 +314,37 @@ QVariant PropertyEditor::fromString(const QString &value, const PropertyContext
 
     case qMetaTypeId<std::uint32_t>():
     {
-        std::uint32_t uintValue = value.toUInt(&_ok);
+        uint uintValue = 0;
 
-        if (!_ok)
+        if (!PM::internal::parseNumber(value, uintValue))
             break;
 
-        return uintValue;
+        return std::uint32_t(uintValue);
     }
 
     case qMetaTypeId<std::int64_t>():
     {
-        std::int64_t longValue = value.toLongLong(&_ok);
+        qint64 longValue = 0;
 
-        if (!_ok)
+        if (!PM::internal::parseNumber(value, longValue))
             break;
 
-        return QVariant::fromValue(longValue);
+        return QVariant::fromValue(std::int64_t(longValue));
     }
 
     case qMetaTypeId<std::uint64_t>():
     {
-        std::uint64_t ulongValue = value.toULongLong(&_ok);
+        quint64 ulongValue = 0;
 
-        if (!_ok)
+        if (!PM::internal::parseNumber(value, ulongValue))
             break;
 
-        return QVariant::fromValue(ulongValue);
+        return QVariant::fromValue(std::uint64_t(ulongValue));
     }
 
     case qMetaTypeId<QDate>():
     {
-        QDate dateValue = QDate::fromString(value, Qt::ISODate);
+        QDate dateValue = PM::internal::parseDate(value);
 
         if (!dateValue.isValid())
             break;
@@ -292,6 +425,11 @@ std::variant<QWidget *, QVariantList> PropertyEditor::getDropDown(const Property
     return nullptr;
 }
 
+DropDownListModel *PropertyEditor::getDropDownModel(const PropertyContext &context) const
+{
+    return nullptr;
+}
+
 PropertyEditor::EditStyle PropertyEditor::getEditStyle(const PropertyContext &context) const
 {
     return None;
@@ -329,29 +467,20 @@ bool SizePropertyEditor::canHandle(const PropertyContext &context) const
 
 QString SizePropertyEditor::toString(const PropertyContext &context) const
 {
-    static const char stringTemplate[] = "%1, %2";
-
     const QVariant value = context.value();
     switch (context.property().type())
     {
     case qMetaTypeId<QSize>():
-    {
-        QSize v = value.value<QSize>();
-
-        return QString(stringTemplate).arg(v.width()).arg(v.height());
-    }
+        return PM::internal::formatSize(value.value<QSize>());
 
     case qMetaTypeId<QSizeF>():
-    {
-        QSizeF v = value.value<QSizeF>();
+        return PM::internal::formatSize(value.value<QSizeF>());
 
-        return QString(stringTemplate).arg(v.width()).arg(v.height());
-    }
     default:
         break;
     }
 
-    return QString(stringTemplate).arg(0).arg(0);
+    return PM::internal::formatSize(QSize(0, 0));
 }
 
 bool RectPropertyEditor::canHandle(const PropertyContext &context) const
@@ -373,29 +502,20 @@ bool RectPropertyEditor::canHandle(const PropertyContext &context) const
 
 QString RectPropertyEditor::toString(const PropertyContext &context) const
 {
-    static const char stringTemplate[] = "%1, %2, %3, %4";
-
     const QVariant value = context.value();
     switch (context.property().type())
     {
     case qMetaTypeId<QRect>():
-    {
-        QRect v = value.value<QRect>();
-
-        return QString(stringTemplate).arg(v.x()).arg(v.y()).arg(v.width()).arg(v.height());
-    }
+        return PM::internal::formatRect(value.value<QRect>());
 
     case qMetaTypeId<QRectF>():
-    {
-        QRectF v = value.value<QRectF>();
+        return PM::internal::formatRect(value.value<QRectF>());
 
-        return QString(stringTemplate).arg(v.x()).arg(v.y()).arg(v.width()).arg(v.height());
-    }
     default:
         break;
     }
 
-    return QString(stringTemplate).arg(0).arg(0).arg(0).arg(0);
+    return PM::internal::formatRect(QRect(0, 0, 0, 0));
 }
 
 bool FontPropertyEditor::canHandle(const PropertyContext &context) const
@@ -421,9 +541,9 @@ QString FontPropertyEditor::toString(const PropertyContext &context) const
     components.append(font.family());
 
     if (font.pointSize() > 0)
-        components.append(QString("%1pt").arg(font.pointSize()));
+        components.append(PM::internal::TextFormatter().appendNumber(font.pointSize()).appendLiteral("pt").toString());
     else
-        components.append(QString("%1px").arg(font.pixelSize()));
+        components.append(PM::internal::TextFormatter().appendNumber(font.pixelSize()).appendLiteral("px").toString());
 
     // Conditional properties
     if (font.weight() != defaultFont.weight())
@@ -506,33 +626,52 @@ QVariant FontPropertyEditor::modalClicked(const PropertyContext &context) const
 
 PropertyEditor::EditStyle FontPropertyEditor::getEditStyle(const PropertyContext &context) const
 {
-    return Modal;
+    // the families are picked from the drop-down, the rest of the font (size, weight, ...) in the font dialog
+    return DropDownWithModal;
 }
 
-QPixmap FontPropertyEditor::getPreviewIcon(const PropertyContext &context) const
+DropDownListModel *FontPropertyEditor::getDropDownModel(const PropertyContext &context) const
 {
-    const QFont font = context.value().value<QFont>();
+    FontFamilyCache &cache = FontFamilyCache::instance();
+    cache.prefetch();
 
-    QPixmap result(PROPERTY_EDITOR_DECORATION_WIDTH, PROPERTY_EDITOR_DECORATION_HEIGHT);
-    result.fill(QApplication::palette().color(QPalette::Highlight));
+    // every family is offered with the rest of the current font, the list follows the cache while it's shown
+    const QFont font = context.value().value<QFont>();
+    const auto families = std::make_shared<QStringList>(cache.families());
 
-    QPainter painter(&result);
-    painter.setRenderHint(QPainter::Antialiasing);
+    auto result = new DropDownListModel(int(families->size()),
+                                        [font, families](int row)
+                                        {
+                                            QFont itemFont = font;
+                                            itemFont.setFamily(families->at(row));
 
-    QFont fixedSizeFont = font;
-    fixedSizeFont.setPointSize(QApplication::font().pointSize());
+                                            return itemFont;
+                                        });
 
-    static const QString previewString = "Ab";
+    result->setDecorationFunction(
+        [](const QVariant &value)
+        {
+            //
+            return FontFamilyCache::instance().preview(value.value<QFont>().family(),
+                                                       QSize(PROPERTY_EDITOR_DECORATION_WIDTH, PROPERTY_EDITOR_DECORATION_HEIGHT));
+        });
+
+    QObject::connect(&cache, &FontFamilyCache::familiesChanged, result,
+                     [result, families]()
+                     {
+                         *families = FontFamilyCache::instance().families();
+                         result->setRowCount(int(families->size()));
+                     });
 
-    QFontMetrics fontMetrics(font);
-    QRect textRectangle = fontMetrics.boundingRect(previewString);
-    textRectangle.moveCenter(result.rect().center());
+    return result;
+}
 
-    painter.setFont(fixedSizeFont);
-    painter.setPen(QApplication::palette().color(QPalette::HighlightedText));
-    painter.drawText(textRectangle, previewString);
+QPixmap FontPropertyEditor::getPreviewIcon(const PropertyContext &context) const
+{
+    // NOTE: font properties are about to be shown, so the drop-down will most probably need the font families soon
+    FontFamilyCache::instance().prefetch();
 
-    return result;
+    return renderFontPreview(context.value().value<QFont>(), QSize(PROPERTY_EDITOR_DECORATION_WIDTH, PROPERTY_EDITOR_DECORATION_HEIGHT));
 }
 
 bool ColorPropertyEditor::canHandle(const PropertyContext &context) const
@@ -542,11 +681,8 @@ bool ColorPropertyEditor::canHandle(const PropertyContext &context) const
 
 QString ColorPropertyEditor::toString(const PropertyContext &context) const
 {
-    static const char stringTemplate[] = "%1, %2, %3, (%4)";
-
     // TODO: implement showing the name of named colors
-    QColor v = context.value().value<QColor>();
-    return QString(stringTemplate).arg(v.red()).arg(v.green()).arg(v.blue()).arg(v.alpha());
+    return PM::internal::formatColor(context.value().value<QColor>());
 }
 
 QVariant ColorPropertyEditor::modalClicked(const PropertyContext &context) const
@@ -679,3 +815,13 @@ PropertyEditor::EditStyle BoolPropertyEditor::getEditStyle(const PropertyContext
 {
     return DropDown;
 }
+
+bool BlobPropertyEditor::canHandle(const PropertyContext &context) const
+{
+    return context.property().type() == qMetaTypeId<PropertyBlob>();
+}
+
+QString BlobPropertyEditor::toString(const PropertyContext &context) const
+{
+    return PM::internal::formatBlob(context.value().value<PropertyBlob>());
+}
@@ -5,8 +5,10 @@
 
 #include <QTreeWidgetItem>
 
+#include <QAbstractListModel>
 #include <QPointer>
 #include <variant>
+#include <vector>
 
 namespace PM
 {
@@ -28,8 +30,55 @@ namespace internal
 
     using PropertyEditorsMap_t = std::unordered_map<TypeId, std::shared_ptr<PropertyEditor>>;
     const PropertyEditorsMap_t &defaultPropertyEditors();
+
+    // returns nullptr if none of the given editors can handle the context
+    PropertyEditor *findPropertyEditor(const PropertyEditorsMap_t &editors, const PropertyContext &context);
 } // namespace internal
 
+//
+// A drop-down list for huge sets of values (large enumerations, lists of files, ...). Instead of a QVariantList
+// holding every value up front, it only knows how many values there are and gets them one at a time, their text
+// is only generated once an item actually gets shown (or searched).
+//
+class DropDownListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    using ValueFunction = std::function<QVariant(int row)>;
+    using TextFunction = std::function<QString(const QVariant &value)>;
+    using DecorationFunction = std::function<QVariant(const QVariant &value)>; // a QPixmap or a QIcon
+
+    // NOTE: without a text function, the values are converted using the editor of the property being edited
+    DropDownListModel(int count, const ValueFunction &valueFunction, const TextFunction &textFunction = TextFunction(),
+                      QObject *parent = nullptr);
+    explicit DropDownListModel(const QVariantList &values, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override; // the value is the Qt::UserRole
+
+    QVariant value(int row) const;
+    QString text(int row) const;
+
+    // the row holding the value, or -1. only the values get compared (no text is generated), the hint row first
+    int findValue(const QVariant &value, int hintRow = -1) const;
+
+    bool hasTextFunction() const;
+    void setTextFunction(const TextFunction &textFunction);
+    void setDecorationFunction(const DecorationFunction &decorationFunction);
+
+    // for lists that change while they are shown, e.g. when they are still being loaded. this resets the model
+    void setRowCount(int count);
+
+private:
+    int m_count;
+    ValueFunction m_valueFunction;
+    TextFunction m_textFunction;
+    DecorationFunction m_decorationFunction;
+
+    mutable std::vector<QString> m_texts; // null until the text of the row is first needed
+};
+
 class PropertyEditor
 {
 public:
@@ -37,7 +86,8 @@ public:
     {
         None = 0,
         Modal = 1,
-        DropDown = 2
+        DropDown = 2,
+        DropDownWithModal = DropDown | Modal // a drop-down along with a button that calls modalClicked()
     };
 
     PropertyEditor() = default;
@@ -57,6 +107,8 @@ public:
     virtual QVariant modalClicked(const PropertyContext &context) const; // FIXME: is this the best we can do?!!
     // TODO: should we return a QStringList or a QVariantList
     virtual std::variant<QWidget *, QVariantList> getDropDown(const PropertyContext &context) const;
+    // takes precedence over getDropDown() when it returns a model. models without a parent get deleted with the editor widget
+    virtual DropDownListModel *getDropDownModel(const PropertyContext &context) const;
 
     virtual QPixmap getPreviewIcon(const PropertyContext &context) const; // FIXME: find a better name
 
@@ -92,6 +144,8 @@ public:
 
     QVariant modalClicked(const PropertyContext &context) const override;
     EditStyle getEditStyle(const PropertyContext &context) const override;
+    // the installed font families, enumerated once per process in the background
+    DropDownListModel *getDropDownModel(const PropertyContext &context) const override;
 
     QPixmap getPreviewIcon(const PropertyContext &context) const override;
 };
@@ -139,6 +193,13 @@ public:
     std::variant<QWidget *, QVariantList> getDropDown(const PropertyContext &context) const override;
 };
 
+class BlobPropertyEditor : public PropertyEditor
+{
+public:
+    bool canHandle(const PropertyContext &context) const override;
+    QString toString(const PropertyContext &context) const override;
+};
+
 } // namespace PM
 
 #endif // PROPERTYEDITOR_H
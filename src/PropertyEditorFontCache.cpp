@@ -0,0 +1,190 @@
+#include "PropertyEditorFontCache_p.h"
+
+#include "QtCompat_p.h"
+
+#include <QApplication>
+#include <QCollator>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <algorithm>
+
+namespace
+{
+// previews are tiny, this keeps a few screens of drop-down items around
+const int FONT_FAMILY_CACHE_MAX_PREVIEWS = 512;
+} // namespace
+
+using namespace PM;
+
+struct internal::FontFamilyEnumerationJob
+{
+    QMutex mutex;
+    FontFamilyCache *receiver; // guarded by `mutex`, gets reset when the cache is destroyed
+    quint64 generation;
+
+    QStringList families;
+
+public:
+    FontFamilyEnumerationJob(FontFamilyCache *receiver, quint64 generation) : receiver(receiver), generation(generation)
+    {
+    }
+};
+
+namespace
+{
+class FontFamilyEnumerationTask : public QRunnable
+{
+public:
+    explicit FontFamilyEnumerationTask(const std::shared_ptr<internal::FontFamilyEnumerationJob> &job) : m_job(job)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        QStringList families = internal::fontFamilies();
+
+        QCollator collator;
+        collator.setCaseSensitivity(Qt::CaseInsensitive);
+        std::sort(families.begin(), families.end(), collator);
+
+        QMutexLocker locker(&m_job->mutex);
+
+        if (m_job->receiver == nullptr)
+            return;
+
+        m_job->families = std::move(families);
+
+        // NOTE: the receiver can't get destroyed while we are holding the mutex, see ~FontFamilyCache()
+        QMetaObject::invokeMethod(m_job->receiver, "onEnumerationFinished", Qt::QueuedConnection, Q_ARG(quint64, m_job->generation));
+    }
+
+private:
+    std::shared_ptr<internal::FontFamilyEnumerationJob> m_job;
+};
+} // namespace
+
+QPixmap internal::renderFontPreview(const QFont &font, const QSize &size)
+{
+    QPixmap result(size);
+    result.fill(QApplication::palette().color(QPalette::Highlight));
+
+    QPainter painter(&result);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QFont fixedSizeFont = font;
+    fixedSizeFont.setPointSize(QApplication::font().pointSize());
+
+    static const QString previewString = "Ab";
+
+    QFontMetrics fontMetrics(font);
+    QRect textRectangle = fontMetrics.boundingRect(previewString);
+    textRectangle.moveCenter(result.rect().center());
+
+    painter.setFont(fixedSizeFont);
+    painter.setPen(QApplication::palette().color(QPalette::HighlightedText));
+    painter.drawText(textRectangle, previewString);
+
+    return result;
+}
+
+internal::FontFamilyCache &internal::FontFamilyCache::instance()
+{
+    // NOTE: owned by the application, so that it goes away before the font database does
+    static FontFamilyCache *result = new FontFamilyCache(qApp);
+
+    return *result;
+}
+
+internal::FontFamilyCache::FontFamilyCache(QObject *parent) :
+    QObject(parent),
+    m_isReady(false),
+    m_generation(0),
+    m_previews(FONT_FAMILY_CACHE_MAX_PREVIEWS)
+{
+    // NOTE: the string based connection is on purpose, the signal doesn't exist in every supported Qt version
+    if (qApp != nullptr && qApp->metaObject()->indexOfSignal("fontDatabaseChanged()") >= 0)
+        connect(qApp, SIGNAL(fontDatabaseChanged()), this, SLOT(refresh()));
+}
+
+internal::FontFamilyCache::~FontFamilyCache()
+{
+    if (m_job == nullptr)
+        return;
+
+    QMutexLocker locker(&m_job->mutex);
+    m_job->receiver = nullptr;
+}
+
+void internal::FontFamilyCache::prefetch()
+{
+    if (m_isReady || m_job != nullptr)
+        return;
+
+    refresh();
+}
+
+bool internal::FontFamilyCache::isReady() const
+{
+    return m_isReady;
+}
+
+QStringList internal::FontFamilyCache::families() const
+{
+    return m_families;
+}
+
+QPixmap internal::FontFamilyCache::preview(const QString &family, const QSize &size)
+{
+    const QPixmap *cachedPreview = m_previews.object(family);
+    if (cachedPreview != nullptr)
+        return *cachedPreview;
+
+    const QPixmap result = renderFontPreview(QFont(family), size);
+    m_previews.insert(family, new QPixmap(result));
+
+    return result;
+}
+
+void internal::FontFamilyCache::refresh()
+{
+    // an enumeration that is still running might have missed the change, its result gets superseded
+    if (m_job != nullptr)
+    {
+        QMutexLocker locker(&m_job->mutex);
+        m_job->receiver = nullptr;
+    }
+
+    m_job = std::make_shared<FontFamilyEnumerationJob>(this, ++m_generation);
+
+    QThreadPool::globalInstance()->start(new FontFamilyEnumerationTask(m_job));
+}
+
+void internal::FontFamilyCache::onEnumerationFinished(quint64 generation)
+{
+    if (m_job == nullptr || m_job->generation != generation)
+        return;
+
+    QStringList families = std::move(m_job->families);
+    m_job.reset();
+
+    m_isReady = true;
+
+    if (families == m_families)
+        return;
+
+    // only the previews of the families that went away are dropped, the others are still valid
+    const QStringList cachedFamilies = m_previews.keys();
+    for (const QString &family : cachedFamilies)
+    {
+        if (!families.contains(family))
+            m_previews.remove(family);
+    }
+
+    m_families = std::move(families);
+
+    emit familiesChanged();
+}
@@ -0,0 +1,78 @@
+#ifndef PROPERTYEDITORFONTCACHE_P_H
+#define PROPERTYEDITORFONTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QCache>
+#include <QFont>
+#include <QObject>
+#include <QPixmap>
+#include <QStringList>
+
+#include <memory>
+
+namespace PM
+{
+namespace internal
+{
+    struct FontFamilyEnumerationJob;
+
+    // the "Ab" sample shown next to fonts
+    QPixmap renderFontPreview(const QFont &font, const QSize &size);
+
+    //
+    // Process-wide cache of the installed font families, so that font drop-downs never enumerate them on their own.
+    // The families get enumerated once on a background thread, and again whenever the font database changes
+    // (application fonts being added or removed, system fonts being installed, ...). The previews are rendered
+    // on first use only and survive a refresh as long as their family is still installed.
+    //
+    // NOTE: this lives on the GUI thread, as do the previews (they are QPixmaps)
+    //
+    class FontFamilyCache : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        static FontFamilyCache &instance();
+        ~FontFamilyCache();
+
+        // starts the first enumeration, if it didn't happen yet
+        void prefetch();
+
+        bool isReady() const;
+        QStringList families() const; // sorted, empty until the first enumeration has finished
+
+        // NOTE: previews are cached by family only, callers are expected to always ask for the same size
+        QPixmap preview(const QString &family, const QSize &size);
+
+    signals:
+        void familiesChanged();
+
+    private slots:
+        void refresh();
+        void onEnumerationFinished(quint64 generation);
+
+    private:
+        explicit FontFamilyCache(QObject *parent = nullptr);
+
+    private:
+        QStringList m_families;
+        bool m_isReady;
+
+        std::shared_ptr<FontFamilyEnumerationJob> m_job;
+        quint64 m_generation;
+
+        QCache<QString, QPixmap> m_previews;
+    };
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYEDITORFONTCACHE_P_H
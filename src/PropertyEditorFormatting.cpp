@@ -0,0 +1,426 @@
+#include "PropertyEditorFormatting_p.h"
+
+#include <algorithm>
+#include <cstring>
+
+// NOTE: SSE2 is part of every x86-64 target, MSVC doesn't define __SSE2__ though
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FORMATTING_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+const char FORMATTING_VALUES_SEPARATOR[] = ", ";
+
+const char FORMATTING_HEX_DIGITS[] = "0123456789abcdef";
+
+// the longest plain ASCII text that gets parsed in place, longer ones fall back to Qt
+const int FORMATTING_PARSE_BUFFER_SIZE = 64;
+
+void appendPadded(PM::internal::TextFormatter &formatter, int value, int width)
+{
+    for (int i = 1, limit = 10; i < width; ++i, limit *= 10)
+    {
+        if (value < limit)
+            formatter.appendChar('0');
+    }
+
+    formatter.appendNumber(value);
+}
+
+// copies the text without its leading and trailing whitespace, returns -1 if it isn't plain ASCII or doesn't fit
+int toTrimmedAscii(const QString &text, char *buffer, int capacity)
+{
+    int first = 0;
+    int last = text.size();
+
+    while (first < last && text.at(first).isSpace())
+        first++;
+
+    while (last > first && text.at(last - 1).isSpace())
+        last--;
+
+    if (last - first > capacity)
+        return -1;
+
+    for (int i = first; i < last; ++i)
+    {
+        const ushort character = text.at(i).unicode();
+
+        if (character == 0 || character > 0x7f)
+            return -1;
+
+        buffer[i - first] = char(character);
+    }
+
+    return last - first;
+}
+
+template <typename T>
+bool parseInPlace(const QString &text, T &result)
+{
+    char buffer[FORMATTING_PARSE_BUFFER_SIZE];
+    const int size = toTrimmedAscii(text, buffer, FORMATTING_PARSE_BUFFER_SIZE);
+
+    if (size <= 0)
+        return false;
+
+    const char *first = buffer;
+    const char *last = buffer + size;
+
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        // NOTE: from_chars also knows about "infinity" and "nan(...)", those are left to Qt
+        const bool isPlainNumber = std::all_of(first, last, [](char c) { return (c >= '0' && c <= '9') || std::strchr(".eE+-", c) != nullptr; });
+
+        if (!isPlainNumber)
+            return false;
+    }
+
+    // from_chars doesn't accept the plus sign that Qt allows
+    if (*first == '+')
+    {
+        ++first;
+
+        if (first == last || *first == '-')
+            return false;
+    }
+
+    T value;
+    const std::from_chars_result parseResult = std::from_chars(first, last, value);
+
+    if (parseResult.ec != std::errc() || parseResult.ptr != last)
+        return false;
+
+    result = value;
+
+    return true;
+}
+} // namespace
+
+using namespace PM;
+
+internal::TextFormatter::TextFormatter() : m_size(0)
+{
+}
+
+internal::TextFormatter &internal::TextFormatter::appendNumber(double value)
+{
+#if defined(__cpp_lib_to_chars)
+    const std::to_chars_result result = std::to_chars(m_buffer + m_size, m_buffer + capacity, value, std::chars_format::general, 6);
+
+    Q_ASSERT(result.ec == std::errc());
+    m_size = int(result.ptr - m_buffer);
+#else
+    // NOTE: not every standard library has floating point to_chars yet, and snprintf() would depend on the C locale
+    appendLiteral(QByteArray::number(value, 'g', 6).constData());
+#endif
+
+    return *this;
+}
+
+internal::TextFormatter &internal::TextFormatter::appendLiteral(const char *text)
+{
+    const int length = int(std::strlen(text));
+
+    Q_ASSERT(m_size + length <= capacity);
+    std::memcpy(m_buffer + m_size, text, size_t(length));
+    m_size += length;
+
+    return *this;
+}
+
+internal::TextFormatter &internal::TextFormatter::appendChar(char character)
+{
+    Q_ASSERT(m_size < capacity);
+    m_buffer[m_size++] = character;
+
+    return *this;
+}
+
+internal::TextFormatter &internal::TextFormatter::appendHex(const char *data, int size)
+{
+    if (size <= 0)
+        return *this;
+
+    Q_ASSERT(m_size + size * 3 - 1 <= capacity);
+
+    // the digits are encoded at the end of the free space first, then spread out from the front, never overwriting unread ones
+    char *digits = m_buffer + capacity - size * 2;
+    encodeHex(data, size, digits);
+
+    for (int i = 0; i < size; ++i)
+    {
+        if (i > 0)
+            m_buffer[m_size++] = ' ';
+
+        m_buffer[m_size++] = digits[i * 2];
+        m_buffer[m_size++] = digits[i * 2 + 1];
+    }
+
+    return *this;
+}
+
+internal::TextFormatter &internal::TextFormatter::appendPrintable(const char *data, int size)
+{
+    Q_ASSERT(m_size + size <= capacity);
+
+    for (int i = 0; i < size; ++i)
+        m_buffer[m_size++] = data[i] >= 0x20 && data[i] < 0x7f ? data[i] : '.';
+
+    return *this;
+}
+
+QString internal::TextFormatter::toString() const
+{
+    return QString::fromLatin1(m_buffer, m_size);
+}
+
+QString internal::formatNumber(int value)
+{
+    return TextFormatter().appendNumber(value).toString();
+}
+
+QString internal::formatNumber(uint value)
+{
+    return TextFormatter().appendNumber(value).toString();
+}
+
+QString internal::formatNumber(qint64 value)
+{
+    return TextFormatter().appendNumber(value).toString();
+}
+
+QString internal::formatNumber(quint64 value)
+{
+    return TextFormatter().appendNumber(value).toString();
+}
+
+QString internal::formatNumber(double value)
+{
+    return TextFormatter().appendNumber(value).toString();
+}
+
+QString internal::formatSize(const QSize &value)
+{
+    TextFormatter formatter;
+    formatter.appendNumber(value.width()).appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.height());
+
+    return formatter.toString();
+}
+
+QString internal::formatSize(const QSizeF &value)
+{
+    TextFormatter formatter;
+    formatter.appendNumber(double(value.width())).appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(double(value.height()));
+
+    return formatter.toString();
+}
+
+QString internal::formatRect(const QRect &value)
+{
+    TextFormatter formatter;
+    formatter.appendNumber(value.x()).appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.y());
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.width());
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.height());
+
+    return formatter.toString();
+}
+
+QString internal::formatRect(const QRectF &value)
+{
+    TextFormatter formatter;
+    formatter.appendNumber(double(value.x())).appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(double(value.y()));
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(double(value.width()));
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(double(value.height()));
+
+    return formatter.toString();
+}
+
+QString internal::formatColor(const QColor &value)
+{
+    TextFormatter formatter;
+    formatter.appendNumber(value.red()).appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.green());
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendNumber(value.blue());
+    formatter.appendLiteral(FORMATTING_VALUES_SEPARATOR).appendChar('(').appendNumber(value.alpha()).appendChar(')');
+
+    return formatter.toString();
+}
+
+QString internal::formatDate(const QDate &value)
+{
+    // NOTE: Qt has its own rules for years that don't fit in four digits
+    if (!value.isValid() || value.year() < 0 || value.year() > 9999)
+        return value.toString(Qt::ISODate);
+
+    TextFormatter formatter;
+    appendPadded(formatter, value.year(), 4);
+    formatter.appendChar('-');
+    appendPadded(formatter, value.month(), 2);
+    formatter.appendChar('-');
+    appendPadded(formatter, value.day(), 2);
+
+    return formatter.toString();
+}
+
+QString internal::formatBlob(const PropertyBlob &value)
+{
+    const int rowSize = int(std::min<qint64>(value.size(), hexRowSize));
+
+    TextFormatter formatter;
+    formatter.appendHex(value.constData(), rowSize);
+
+    if (value.size() <= hexRowSize)
+    {
+        // the printable characters are aligned with the ones of full rows
+        for (int i = rowSize; i < hexRowSize; ++i)
+            formatter.appendLiteral("   ");
+
+        formatter.appendLiteral("  ").appendPrintable(value.constData(), rowSize);
+    }
+    else
+    {
+        formatter.appendLiteral(" ... (").appendNumber(value.size()).appendLiteral(" bytes)");
+    }
+
+    return formatter.toString();
+}
+
+QString internal::formatOffset(qint64 value)
+{
+    char digits[16];
+    int count = 0;
+
+    for (quint64 remaining = quint64(value); remaining != 0 || count < 8; remaining >>= 4)
+        digits[count++] = FORMATTING_HEX_DIGITS[remaining & 0xf];
+
+    TextFormatter formatter;
+    formatter.appendLiteral("0x");
+
+    while (count > 0)
+        formatter.appendChar(digits[--count]);
+
+    return formatter.toString();
+}
+
+void internal::encodeHex(const char *data, int size, char *result)
+{
+    int i = 0;
+
+#if defined(FORMATTING_HAS_SSE2)
+    const __m128i lowNibbleMask = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i letterOffset = _mm_set1_epi8('a' - '0' - 10);
+
+    // the nibbles above 9 skip the characters between '9' and 'a'
+    const auto toDigits = [&](__m128i nibbles)
+    {
+        //
+        return _mm_add_epi8(_mm_add_epi8(nibbles, zero), _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letterOffset));
+    };
+
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+
+        // the digits of the high and low nibbles get interleaved
+        const __m128i high = toDigits(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbleMask));
+        const __m128i low = toDigits(_mm_and_si128(bytes, lowNibbleMask));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        const uchar byte = uchar(data[i]);
+
+        result[i * 2] = FORMATTING_HEX_DIGITS[byte >> 4];
+        result[i * 2 + 1] = FORMATTING_HEX_DIGITS[byte & 0xf];
+    }
+}
+
+bool internal::parseNumber(const QString &text, int &result)
+{
+    if (parseInPlace(text, result))
+        return true;
+
+    bool ok = false;
+    result = text.toInt(&ok);
+
+    return ok;
+}
+
+bool internal::parseNumber(const QString &text, uint &result)
+{
+    if (parseInPlace(text, result))
+        return true;
+
+    bool ok = false;
+    result = text.toUInt(&ok);
+
+    return ok;
+}
+
+bool internal::parseNumber(const QString &text, qint64 &result)
+{
+    if (parseInPlace(text, result))
+        return true;
+
+    bool ok = false;
+    result = text.toLongLong(&ok);
+
+    return ok;
+}
+
+bool internal::parseNumber(const QString &text, quint64 &result)
+{
+    if (parseInPlace(text, result))
+        return true;
+
+    bool ok = false;
+    result = text.toULongLong(&ok);
+
+    return ok;
+}
+
+bool internal::parseNumber(const QString &text, double &result)
+{
+#if defined(__cpp_lib_to_chars)
+    if (parseInPlace(text, result))
+        return true;
+#endif
+
+    bool ok = false;
+    result = text.toDouble(&ok);
+
+    return ok;
+}
+
+QDate internal::parseDate(const QString &text)
+{
+    // the plain "yyyy-MM-dd" form is parsed in place, anything else is left to Qt
+    const auto isDigit = [&text](int i) { return text.at(i) >= QLatin1Char('0') && text.at(i) <= QLatin1Char('9'); };
+    const auto digits = [&text](int first, int count)
+    {
+        int result = 0;
+        for (int i = first; i < first + count; ++i)
+            result = result * 10 + (text.at(i).unicode() - '0');
+
+        return result;
+    };
+
+    if (text.size() != 10 || text.at(4) != QLatin1Char('-') || text.at(7) != QLatin1Char('-'))
+        return QDate::fromString(text, Qt::ISODate);
+
+    for (int i : {0, 1, 2, 3, 5, 6, 8, 9})
+    {
+        if (!isDigit(i))
+            return QDate::fromString(text, Qt::ISODate);
+    }
+
+    return QDate(digits(0, 4), digits(5, 2), digits(8, 2));
+}
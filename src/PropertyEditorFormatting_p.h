@@ -0,0 +1,103 @@
+#ifndef PROPERTYEDITORFORMATTING_P_H
+#define PROPERTYEDITORFORMATTING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include "PropertyBlob.h"
+
+#include <QColor>
+#include <QDate>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+#include <charconv>
+#include <type_traits>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // Formats values into a fixed-size buffer on the stack, the resulting QString is the only allocation.
+    // Everything is locale independent and matches what QString::number() and QString::arg() produce
+    // (doubles use the 'g' format with 6 significant digits).
+    //
+    class TextFormatter
+    {
+    public:
+        TextFormatter();
+
+        template <typename T>
+        TextFormatter &appendNumber(T value);
+        TextFormatter &appendNumber(double value);
+        TextFormatter &appendLiteral(const char *text); // Latin-1
+        TextFormatter &appendChar(char character);
+        TextFormatter &appendHex(const char *data, int size);       // "de ad be ef"
+        TextFormatter &appendPrintable(const char *data, int size); // non-printable characters become '.'
+
+        QString toString() const;
+
+    private:
+        // large enough for the four doubles of a QRectF and their separators, or a full row of a hex view
+        static const int capacity = 128;
+
+        char m_buffer[capacity];
+        int m_size;
+    };
+
+    QString formatNumber(int value);
+    QString formatNumber(uint value);
+    QString formatNumber(qint64 value);
+    QString formatNumber(quint64 value);
+    QString formatNumber(double value);
+
+    QString formatSize(const QSize &value);
+    QString formatSize(const QSizeF &value);
+    QString formatRect(const QRect &value);
+    QString formatRect(const QRectF &value);
+    QString formatColor(const QColor &value);
+    QString formatDate(const QDate &value); // ISO 8601, same as QDate::toString(Qt::ISODate)
+
+    // blobs are shown as hex dumps, a blob that doesn't fit in one row only gets its first row shown, followed by its size
+    static const int hexRowSize = 16;
+    QString formatBlob(const PropertyBlob &value);
+    QString formatOffset(qint64 value); // "0x0001f400", at least 8 digits
+
+    // writes two lowercase hex digits per byte to `result`, 16 bytes at a time where SSE2 is available
+    void encodeHex(const char *data, int size, char *result);
+
+    // NOTE: these accept the same input as their QString::toInt()/toDouble()/... counterparts, leading and trailing
+    //       whitespace included. plain ASCII input is parsed in place, anything else falls back to Qt
+    bool parseNumber(const QString &text, int &result);
+    bool parseNumber(const QString &text, uint &result);
+    bool parseNumber(const QString &text, qint64 &result);
+    bool parseNumber(const QString &text, quint64 &result);
+    bool parseNumber(const QString &text, double &result);
+
+    QDate parseDate(const QString &text); // ISO 8601, same as QDate::fromString(text, Qt::ISODate)
+} // namespace internal
+} // namespace PM
+
+template <typename T>
+inline PM::internal::TextFormatter &PM::internal::TextFormatter::appendNumber(T value)
+{
+    static_assert(std::is_integral<T>::value, "T must be an integral type");
+
+    const std::to_chars_result result = std::to_chars(m_buffer + m_size, m_buffer + capacity, value);
+
+    Q_ASSERT(result.ec == std::errc());
+    m_size = int(result.ptr - m_buffer);
+
+    return *this;
+}
+
+#endif // PROPERTYEDITORFORMATTING_P_H
@@ -2,14 +2,25 @@
 #include "PropertyGrid_p.h"
 
 #include "PropertyContext_p.h"
+#include "PropertyGridMemory_p.h"
 #include "PropertyGridTreeItem_p.h"
+#include "PropertyGridTrace_p.h"
 #include "PropertyGridTreeModel_p.h"
+#include "PropertyGridValues_p.h"
 #include "QtCompat_p.h"
 
 #include <QComboBox>
+#include <QCompleter>
+#include <QElapsedTimer>
+#include <QIODevice>
 #include <QLineEdit>
+#include <QListView>
 #include <QMessageBox>
 #include <QPainter>
+#include <QScrollBar>
+
+#include <algorithm>
+#include <unordered_set>
 
 namespace
 {
@@ -17,10 +28,37 @@ namespace
 const std::uint32_t PROPERTY_EDITOR_DECORATION_WIDTH = 20;
 const std::uint32_t PROPERTY_EDITOR_DECORATION_HEIGHT = 16;
 
+// the memory budget gets checked at most this often, see PropertyGrid::setMemoryBudget()
+const int PROPERTY_GRID_MEMORY_BUDGET_CHECK_INTERVAL = 500;
+
+// rough size of a widget along with its private data, for the estimates of the open editors
+const quint64 PROPERTY_GRID_WIDGET_SIZE_ESTIMATE = 512;
+
 const char PROPERTY_EDITOR_WIDGET_CHILD_STYLE_SHEET[] = R"(
                 margin: 0px;
                 padding: 0px;
         )";
+
+// visits the contexts of the properties below the category in the order of the tree, those that are still pending included.
+// stops as soon as the function returns false
+template <typename Function>
+bool forEachPropertyContext(const PM::internal::PropertyGridTreeItem *categoryItem, const Function &function)
+{
+    for (const auto &child : categoryItem->children)
+    {
+        const bool shouldContinue = child->isTransient ? forEachPropertyContext(child.get(), function) : function(child->context);
+        if (!shouldContinue)
+            return false;
+    }
+
+    for (const PM::PropertyContext &context : categoryItem->pendingChildren)
+    {
+        if (!function(context))
+            return false;
+    }
+
+    return true;
+}
 } // namespace
 
 using namespace PM;
@@ -61,6 +99,30 @@ void internal::PropertyEditorComboBox::setDropDownWidget(QWidget *value)
     m_frameLayout.addWidget(m_dropDownWidget);
 }
 
+void internal::PropertyEditorComboBox::setListModel(DropDownListModel *model)
+{
+    setModel(model);
+
+    // NOTE: the texts of the items are generated on demand, nothing may go through all of them just to measure them
+    setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+
+    QListView *listView = qobject_cast<QListView *>(view());
+    if (listView != nullptr)
+        listView->setUniformItemSizes(true);
+
+    // the completer keeps the matches of the previous input, typing more characters only filters those again
+    QCompleter *listCompleter = new QCompleter(model, this);
+    listCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+    listCompleter->setFilterMode(Qt::MatchContains);
+    listCompleter->setCompletionMode(QCompleter::PopupCompletion);
+
+    QListView *completerView = qobject_cast<QListView *>(listCompleter->popup());
+    if (completerView != nullptr)
+        completerView->setUniformItemSizes(true);
+
+    setCompleter(listCompleter);
+}
+
 void internal::PropertyEditorComboBox::showPopup()
 {
     if (m_dropDownWidget == nullptr)
@@ -144,8 +206,13 @@ internal::PropertyEditorWidget::PropertyEditorWidget(PropertyContext &context, Q
     layout->setContentsMargins(QMargins());
     layout->addWidget(&m_propertylineEdit, 1);
     layout->addWidget(&m_dropDownComboBox, 1);
+    layout->addWidget(&m_dropDownModalButton, 0);
     setLayout(layout);
 
+    m_dropDownModalButton.setText("...");
+    m_dropDownModalButton.setMinimumHeight(m_dropDownComboBox.sizeHint().height());
+    m_dropDownModalButton.setMinimumWidth(m_dropDownModalButton.minimumHeight());
+
     setEditStyle(); // FIXME: find a cleaner solution
     initializeWidgetData();
 
@@ -158,17 +225,8 @@ internal::PropertyEditorWidget::PropertyEditorWidget(PropertyContext &context, Q
                 [this](const PropertyContext &context) { setUiValue(context.value()); });
     }
 
-    connect(m_propertylineEdit.button(), &QToolButton::clicked, this,
-            [this](bool checked)
-            {
-                if (m_context == nullptr || m_context->propertyGrid() == nullptr)
-                    return;
-
-                QVariant newValue = propertyEditor()->modalClicked(propertyContext());
-                PropertyGridPrivate *propertyGridImpl = PropertyGridPrivate::getImpl(*propertyContext().propertyGrid());
-
-                propertyGridImpl->setPropertyValue(propertyContext(), newValue);
-            });
+    connect(m_propertylineEdit.button(), &QToolButton::clicked, this, &PropertyEditorWidget::onModalButtonClicked);
+    connect(&m_dropDownModalButton, &QToolButton::clicked, this, &PropertyEditorWidget::onModalButtonClicked);
 
     connect(&m_dropDownComboBox, qOverload<int>(&PropertyEditorComboBox::currentIndexChanged), this,
             &PropertyEditorWidget::onDropDownComboBoxCurrentIndexChanged);
@@ -203,6 +261,8 @@ QString internal::PropertyEditorWidget::text() const
         return m_propertylineEdit.lineEdit()->text();
 
     case PropertyEditor::DropDown:
+        Q_FALLTHROUGH();
+    case PropertyEditor::DropDownWithModal:
         return m_dropDownComboBox.lineEdit()->text();
 
     default:
@@ -226,10 +286,26 @@ void internal::PropertyEditorWidget::setText(const QString &value)
         break;
 
     case PropertyEditor::DropDown:
+        Q_FALLTHROUGH();
+    case PropertyEditor::DropDownWithModal:
     {
         m_dropDownComboBox.setCurrentText(value);
 
-        int currentIndex = m_dropDownComboBox.findText(value);
+        // NOTE: findText() would generate the text of every item of the list, its items are looked up by value instead
+        int currentIndex = -1;
+
+        const DropDownListModel *model = qobject_cast<const DropDownListModel *>(m_dropDownComboBox.model());
+        if (model != nullptr)
+        {
+            currentIndex = model->findValue(m_uiValue, m_dropDownComboBox.currentIndex());
+            if (currentIndex != -1 && model->text(currentIndex) != value)
+                currentIndex = -1;
+        }
+        else
+        {
+            currentIndex = m_dropDownComboBox.findText(value);
+        }
+
         if (currentIndex != -1)
             m_dropDownComboBox.setCurrentIndex(currentIndex);
     }
@@ -254,6 +330,16 @@ PropertyEditor::EditStyle internal::PropertyEditorWidget::editStyle() const
     return propertyEditor()->getEditStyle(propertyContext());
 }
 
+internal::PropertyGridCounters::EditorCounters *internal::PropertyEditorWidget::editorCounters(const PropertyEditor &editor) const
+{
+    PropertyGrid *propertyGrid = m_context != nullptr ? m_context->propertyGrid() : nullptr;
+
+    if (propertyGrid == nullptr)
+        return nullptr;
+
+    return PropertyGridPrivate::getImpl(*propertyGrid)->editorCounters(editor);
+}
+
 PropertyEditor *internal::PropertyEditorWidget::propertyEditor() const
 {
     PropertyGrid *propertyGrid = m_context->propertyGrid();
@@ -283,27 +369,51 @@ void internal::PropertyEditorWidget::onUiValueChanged()
 
 void internal::PropertyEditorWidget::onTextEditingFinished()
 {
+    PropertyEditor *editor = propertyEditor();
+    PropertyGridCounters::EditorCounters *counters = editorCounters(*editor);
+
     QString errorMessage;
-    QVariant newValue = propertyEditor()->fromString(text(), propertyContext(), &errorMessage);
+    QVariant newValue = PropertyGridCounters::fromString(counters, *editor, text(), propertyContext(), &errorMessage);
 
     if (!errorMessage.isEmpty() || newValue == m_context->value())
         return;
 
-    PropertyEditor *editor = propertyEditor();
-    if (editor->toString(propertyContext()) == text())
+    if (PropertyGridCounters::toString(counters, *editor, propertyContext()) == text())
         return;
 
     setUiValue(newValue);
 }
 
+void internal::PropertyEditorWidget::onModalButtonClicked()
+{
+    if (m_context == nullptr || m_context->propertyGrid() == nullptr)
+        return;
+
+    QVariant newValue = propertyEditor()->modalClicked(propertyContext());
+    PropertyGridPrivate *propertyGridImpl = PropertyGridPrivate::getImpl(*propertyContext().propertyGrid());
+
+    propertyGridImpl->setPropertyValue(propertyContext(), newValue);
+}
+
 void internal::PropertyEditorWidget::onDropDownComboBoxCurrentIndexChanged(int index)
 {
     // If the editor provided a dropdown widget, we don't need to update the ui value
     if (m_dropDownComboBox.dropDownWidget() != nullptr)
         return;
 
-    // FIXME: this looks like it would be better if PropertyEditor::getDropDown returned a QVariantList
-    const QVariant value = propertyEditor()->fromString(m_dropDownComboBox.currentText(), propertyContext());
+    // NOTE: no item is selected while the list gets reset (e.g. when its items change while it's shown), the value is
+    //       kept as it is and gets selected again once the reset is over, see setDropDownModel()
+    if (index == -1)
+        return;
+
+    // the items of drop-down lists carry their values, there is no need to parse their text back
+    QVariant value = m_dropDownComboBox.itemData(index);
+    if (!value.isValid())
+    {
+        const PropertyEditor *editor = propertyEditor();
+        value = PropertyGridCounters::fromString(editorCounters(*editor), *editor, m_dropDownComboBox.currentText(), propertyContext());
+    }
+
     setUiValue(value);
 }
 
@@ -311,8 +421,11 @@ void internal::PropertyEditorWidget::setEditStyle()
 {
     const PropertyEditor::EditStyle style = editStyle();
 
-    m_dropDownComboBox.setVisible(style == PropertyEditor::DropDown);
-    m_propertylineEdit.setVisible(style != PropertyEditor::DropDown);
+    const bool isDropDown = (style & PropertyEditor::DropDown) != 0;
+
+    m_dropDownComboBox.setVisible(isDropDown);
+    m_dropDownModalButton.setVisible(style == PropertyEditor::DropDownWithModal);
+    m_propertylineEdit.setVisible(!isDropDown);
     m_propertylineEdit.button()->setVisible(style == PropertyEditor::Modal);
 
     if (m_dropDownComboBox.isVisible())
@@ -328,34 +441,80 @@ void PM::internal::PropertyEditorWidget::initializeWidgetData()
     //       2. display the string representation for the current property context value
 
     const PropertyEditor *editor = propertyEditor();
-    const QString valueAsString = editor->toString(propertyContext());
+    const QString valueAsString = PropertyGridCounters::toString(editorCounters(*editor), *editor, propertyContext());
 
-    if (editStyle() == PM::PropertyEditor::DropDown)
+    if ((editStyle() & PM::PropertyEditor::DropDown) != 0)
     {
-        auto dropDownData = editor->getDropDown(propertyContext());
+        DropDownListModel *model = editor->getDropDownModel(propertyContext());
 
-        if (std::holds_alternative<QWidget *>(dropDownData))
+        if (model == nullptr)
         {
-            m_dropDownComboBox.setDropDownWidget(std::get<QWidget *>(dropDownData));
-            m_dropDownComboBox.setCurrentText(valueAsString);
-        }
-        else if (std::holds_alternative<QVariantList>(dropDownData))
-        {
-            // FIXME: should we use a QStringList instead of QVariantList?!!
-            const QVariantList valuesList = std::get<QVariantList>(dropDownData);
-            for (const QVariant &value : valuesList)
-                m_dropDownComboBox.addItem(valueToString(value), value);
+            auto dropDownData = editor->getDropDown(propertyContext());
+
+            if (std::holds_alternative<QWidget *>(dropDownData))
+            {
+                m_dropDownComboBox.setDropDownWidget(std::get<QWidget *>(dropDownData));
+                m_dropDownComboBox.setCurrentText(valueAsString);
+            }
+            else if (std::holds_alternative<QVariantList>(dropDownData))
+            {
+                // FIXME: should we use a QStringList instead of QVariantList?!!
+                model = new DropDownListModel(std::get<QVariantList>(dropDownData));
+            }
         }
+
+        if (model != nullptr)
+            setDropDownModel(model);
     }
 
     setUiValue(m_context->value());
 }
 
+void internal::PropertyEditorWidget::setDropDownModel(DropDownListModel *model)
+{
+    if (model->parent() == nullptr)
+        model->setParent(this);
+
+    // NOTE: valueToString() would copy the context and look the editor up again for every single item,
+    //       so the editor is resolved once and all of the items share a single context
+    if (!model->hasTextFunction())
+    {
+        const PropertyEditor *editor = propertyEditor();
+        PropertyGridCounters::EditorCounters *itemCounters = editorCounters(*editor);
+        const auto itemContext = std::make_shared<PropertyContext>(PropertyContextPrivate::createContext(propertyContext(), QVariant()));
+        PropertyContextPrivate::disconnectValueChangedSlot(*itemContext); // the items aren't values of the property
+
+        model->setTextFunction(
+            [editor, itemCounters, itemContext](const QVariant &value)
+            {
+                PropertyContextPrivate::setValue(*itemContext, value);
+
+                return PropertyGridCounters::toString(itemCounters, *editor, *itemContext);
+            });
+    }
+
+    m_dropDownComboBox.setListModel(model);
+
+    // the combo box drops its current item when the list gets reset, the item of the current value is selected again
+    connect(model, &QAbstractItemModel::modelReset, this,
+            [this, model]()
+            {
+                const int currentIndex = model->findValue(m_uiValue);
+
+                if (currentIndex != -1)
+                    m_dropDownComboBox.setCurrentIndex(currentIndex);
+                else
+                    m_dropDownComboBox.setCurrentText(valueToString(m_uiValue));
+            });
+}
+
 QString internal::PropertyEditorWidget::valueToString(const QVariant &value) const
 {
     const PropertyContext newContext = PropertyContextPrivate::createContext(propertyContext(), value);
 
-    return propertyEditor()->toString(newContext);
+    const PropertyEditor *editor = propertyEditor();
+
+    return PropertyGridCounters::toString(editorCounters(*editor), *editor, newContext);
 }
 
 QString internal::ModelIndexHelperFunctions::firstValueInRowAsString(const QModelIndex &index, Qt::ItemDataRole role)
@@ -433,9 +592,13 @@ void internal::PropertyGridItemDelegate::paint(QPainter *painter, const QStyleOp
 
 QWidget *internal::PropertyGridItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
+    const TraceSpan span("PropertyGridItemDelegate::createEditor");
+
     const PropertyGridPrivate *propertyGridPrivate = PropertyGridPrivate::getImpl(*m_parentGrid);
     PropertyContext &context = propertyGridPrivate->m_model.getItem(index)->context;
 
+    propertyGridPrivate->m_model.counters().count(internal::PropertyGridCounters::EditorWidgetCreations);
+
     PropertyEditorWidget *result = new PropertyEditorWidget(context, parent);
 
     //
@@ -443,7 +606,7 @@ QWidget *internal::PropertyGridItemDelegate::createEditor(QWidget *parent, const
     //       This means that the editor might try to access a property context after it got destroyed.
     //       This makes sure that the editor widget will never point to an invalid property context
     //
-    connect(this, &QObject::destroyed, this,
+    connect(this, &QObject::destroyed, result,
             [result]()
             {
                 //
@@ -463,13 +626,20 @@ void internal::PropertyGridItemDelegate::setEditorData(QWidget *editor, const QM
 
 void internal::PropertyGridItemDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
 {
+    const TraceSpan span("PropertyGridItemDelegate::setModelData");
+
     PropertyEditorWidget *propertyEditorWidget = qobject_cast<PropertyEditorWidget *>(editor);
 
     PropertyContext &context = propertyEditorWidget->propertyContext();
 
     PropertyGridPrivate *parentGridPrivate = PropertyGridPrivate::getImpl(*m_parentGrid);
     if (parentGridPrivate->setPropertyValue(context, propertyEditorWidget->uiValue()))
+    {
+        if (parentGridPrivate->m_recorder != nullptr)
+            parentGridPrivate->recordEdit(context);
+
         return;
+    }
 
     QMessageBox::warning(m_parentGrid, "Warning", "Couldn't set data");
 
@@ -488,8 +658,21 @@ PropertyGridPrivate::PropertyGridPrivate(PropertyGrid *q) :
     q(q),
     ui(new Ui::PropertyGrid()),
     tableViewItemDelegate(q),
-    m_propertyEditors(internal::defaultPropertyEditors())
+    m_propertyEditors(internal::defaultPropertyEditors()),
+    m_populationTimeBudget(0),
+    m_populatedCount(0),
+    m_isUpdatingComputedProperties(false),
+    m_memoryBudget(0)
 {
+    m_populationTimer.setInterval(0);
+
+    m_memoryBudgetTimer.setSingleShot(true);
+    m_memoryBudgetTimer.setInterval(PROPERTY_GRID_MEMORY_BUDGET_CHECK_INTERVAL);
+
+    m_model.setItemInitializer([this](internal::PropertyGridTreeItem *item) { initializePropertyItem(item); });
+    m_model.setElementItemInitializer([this](internal::PropertyGridTreeItem *item) { initializeElementItem(item); });
+    m_model.setItemDataLoader([this](internal::PropertyGridTreeItem *item) { updateItemData(item); });
+    m_model.setItemDecorationLoader([this](internal::PropertyGridTreeItem *item) { loadItemDecoration(item); });
 }
 
 PropertyEditor &PropertyGridPrivate::defaultPropertyEditor()
@@ -517,28 +700,272 @@ void PropertyGridPrivate::closeEditor()
 
 void PropertyGridPrivate::updatePropertyValue(const QModelIndex &index, const QVariant &value)
 {
+    const internal::TraceSpan span("PropertyGrid::updatePropertyValue");
+
     internal::PropertyGridTreeItem *item = m_model.getItem(index);
 
     if (item == nullptr)
         return;
 
+    if (item->isElement())
+    {
+        updateElementValue(item, value);
+        return;
+    }
+
     bool valueChanged = item->context.value() != value;
 
     PropertyContext &context = item->context;
-    const PropertyEditor *editor = getEditorForProperty(context);
-
-    QModelIndex valueIndex = PM::internal::siblingAtColumn(index, 1);
 
     PropertyContextPrivate::setValue(context, value);
 
-    m_model.setData(valueIndex, value, Qt::EditRole);
-    m_model.setData(valueIndex, editor->toString(context), Qt::DisplayRole);
-    m_model.setData(valueIndex, generateDecoration(editor->getPreviewIcon(context)), Qt::DecorationRole);
+    updateItemData(item);
+    m_model.notifyItemDataChanged(item, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+    m_model.updateElements(item);
+    m_model.refreshPropertyRow(item);
 
     if (!valueChanged)
         return;
 
     emit q->propertyValueChanged(context);
+
+    updateComputedProperties(context.property().name());
+}
+
+void PropertyGridPrivate::updateElementValue(internal::PropertyGridTreeItem *item, const QVariant &value)
+{
+    // NOTE: the new value gets written back into every container up to the property that owns it, the rows of the
+    //       other elements are left untouched
+    const bool valueChanged = item->context.value() != value;
+
+    QVariant newValue = value;
+    while (item->isElement())
+    {
+        PropertyContextPrivate::setValue(item->context, newValue);
+
+        updateItemData(item);
+        m_model.notifyItemDataChanged(item, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+
+        newValue = item->parent->valueWithElement(item->elementIndex, newValue);
+        item = item->parent;
+    }
+
+    PropertyContextPrivate::setValue(item->context, newValue);
+
+    updateItemData(item);
+    m_model.notifyItemDataChanged(item, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+    m_model.refreshPropertyRow(item);
+
+    if (!valueChanged)
+        return;
+
+    emit q->propertyValueChanged(item->context);
+
+    updateComputedProperties(item->context.property().name());
+}
+
+void PropertyGridPrivate::expandCategories()
+{
+    // categories that are collapsed by default get expanded (and thus fetched) by the user only, unless they are filtered
+    if (!m_model.showCategories() || (!m_model.categoriesExpandedByDefault() && m_model.filterText().isEmpty()))
+        return;
+
+    // NOTE: expandToDepth() can't reach nested categories without also expanding the properties at the same depth
+    for (internal::PropertyGridTreeItem *categoryItem : m_model.categoryItems())
+    {
+        const QModelIndex index = m_model.getItemIndex(categoryItem);
+
+        if (index.isValid())
+            ui->propertiesTreeView->expand(index);
+    }
+}
+
+void PropertyGridPrivate::initializePropertyItem(internal::PropertyGridTreeItem *item) const
+{
+    // NOTE: elements aren't properties on their own, only the property owning them can be computed
+    const ComputedState state = item->isElement() ? ComputedState() : m_computedStates.value(item->context.property().name());
+
+    if (internal::isReadOnly(item->context.property()) || state.isReadOnly)
+        setReadOnlyStyle(item);
+
+    // the item isn't part of the visible rows yet, the model picks this up when inserting it
+    item->isHidden = !state.isVisible;
+
+    updateItemData(item);
+}
+
+void PropertyGridPrivate::initializeElementItem(internal::PropertyGridTreeItem *item) const
+{
+    if (internal::isReadOnly(item->context.property()))
+        setReadOnlyStyle(item);
+
+    // NOTE: the editor lookup, the text and the decoration are left to updateItemData(), see ensureDisplayData()
+    item->setValue(item->context.value());
+    item->evictDisplayData();
+}
+
+void PropertyGridPrivate::setReadOnlyStyle(internal::PropertyGridTreeItem *item) const
+{
+    const QColor disabledTextColor = q->palette().color(QPalette::Disabled, QPalette::Text);
+
+    item->setColumnData(0, Qt::ForegroundRole, disabledTextColor);
+    item->setColumnData(1, Qt::ForegroundRole, disabledTextColor);
+
+    Qt::ItemFlags flags = item->flags(1);
+    flags.setFlag(Qt::ItemIsEditable, false);
+    item->setFlags(1, flags);
+}
+
+void PropertyGridPrivate::updateItemData(internal::PropertyGridTreeItem *item) const
+{
+    // NOTE: this only updates the item, notifying the view is up to the caller
+
+    const PropertyContext &context = item->context;
+    const PropertyEditor *editor = getEditorForProperty(context);
+
+    const QPixmap decoration = generateDecoration(previewIcon(*editor, context));
+
+    // the elements of containers and objects have their own rows, the value only gets summarized
+    const QString summary = editor == &defaultPropertyEditor() ? item->elementsSummary() : QString();
+
+    const QString text = summary.isNull() ? internal::PropertyGridCounters::toString(editorCounters(*editor), *editor, context) : summary;
+
+    item->setValue(context.value());
+    item->setColumnData(1, Qt::DisplayRole, text);
+    item->setColumnData(1, Qt::DecorationRole, decoration.isNull() ? QVariant() : QVariant(decoration));
+}
+
+void PropertyGridPrivate::populateNextSlice()
+{
+    // properties are pulled from the generator in small chunks so that the time budget gets checked often enough
+    static const int chunkSize = 64;
+
+    // NOTE: the population this slice belongs to is over as soon as the member doesn't point to it anymore
+    const std::shared_ptr<PropertyGenerator> generator = m_populationGenerator;
+    if (generator == nullptr)
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int countBefore = m_populatedCount;
+
+    bool exhausted = false;
+    while (!exhausted && timer.elapsed() < m_populationTimeBudget)
+    {
+        std::vector<PropertyContext> chunk;
+        chunk.reserve(chunkSize);
+
+        while (int(chunk.size()) < chunkSize)
+        {
+            Property property;
+            QVariant value;
+
+            const bool hasProperty = (*generator)(property, value);
+
+            // the properties of a population that got cancelled by the generator are dropped
+            if (m_populationGenerator != generator)
+                return;
+
+            if (!hasProperty)
+            {
+                exhausted = true;
+                break;
+            }
+
+            chunk.push_back(PropertyContextPrivate::createContext(property, value, nullptr, q));
+        }
+
+        m_model.addProperties(chunk);
+
+        for (const PropertyContext &context : chunk)
+        {
+            addComputedProperty(context);
+
+            if (m_recorder != nullptr)
+                m_recorder->recordAddProperty(context.property(), context.value());
+        }
+
+        // handlers of the model signals may have cancelled (or restarted) the population
+        if (m_populationGenerator != generator)
+            return;
+
+        m_populatedCount += int(chunk.size());
+    }
+
+    if (m_populatedCount != countBefore)
+        expandCategories();
+
+    emit q->populationProgress(m_populatedCount);
+
+    if (exhausted && m_populationGenerator == generator)
+        finishPopulation(false);
+}
+
+void PropertyGridPrivate::finishPopulation(bool cancelled)
+{
+    // NOTE: populationFinished() gets emitted once per population, whoever ends it first wins
+    if (m_populationGenerator == nullptr)
+        return;
+
+    m_populationTimer.stop();
+
+    // releases whatever state the generator captured, unless a slice is still running it (it lets go once it returns)
+    m_populationGenerator.reset();
+
+    emit q->populationFinished(cancelled);
+}
+
+PropertyGridMemoryUsage PropertyGridPrivate::memoryUsage() const
+{
+    PropertyGridMemoryUsage result = internal::measureMemoryUsage(m_model.rootItem());
+
+    // NOTE: widgets keep most of their state in their private data, which sizeof doesn't see
+    for (const internal::PropertyEditorWidget *editorWidget : q->findChildren<internal::PropertyEditorWidget *>())
+        result.editorWidgetsBytes += quint64(1 + editorWidget->findChildren<QWidget *>().size()) * PROPERTY_GRID_WIDGET_SIZE_ESTIMATE;
+
+    return result;
+}
+
+void PropertyGridPrivate::scheduleMemoryBudgetCheck()
+{
+    if (m_memoryBudget != 0 && !m_memoryBudgetTimer.isActive())
+        m_memoryBudgetTimer.start();
+}
+
+void PropertyGridPrivate::enforceMemoryBudget()
+{
+    if (m_memoryBudget == 0)
+        return;
+
+    const PropertyGridMemoryUsage usage = memoryUsage();
+    if (usage.totalBytes() <= m_memoryBudget)
+        return;
+
+    const internal::TraceSpan span("PropertyGridPrivate::enforceMemoryBudget");
+
+    // the rows on screen keep their caches, they would be generated again right away
+    QTreeView *treeView = ui->propertiesTreeView;
+    const int viewportHeight = treeView->viewport()->height();
+
+    std::unordered_set<const internal::PropertyGridTreeItem *> shownItems;
+    for (QModelIndex index = treeView->indexAt(QPoint(0, 0)); index.isValid() && treeView->visualRect(index).top() < viewportHeight;
+         index = treeView->indexBelow(index))
+        shownItems.insert(m_model.getItem(index));
+
+    std::vector<internal::PropertyGridTreeItem *> candidates = internal::evictableItems(m_model.rootItem());
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [&shownItems](const internal::PropertyGridTreeItem *item)
+                                    {
+                                        //
+                                        return shownItems.count(item) != 0;
+                                    }),
+                     candidates.end());
+
+    // going a bit below the budget keeps scrolling back and forth from evicting on every check
+    const quint64 target = m_memoryBudget - m_memoryBudget / 8;
+
+    m_model.evictDisplayData(std::move(candidates), usage.totalBytes() - target);
 }
 
 bool PropertyGridPrivate::setPropertyValue(const PropertyContext &context, const QVariant &value)
@@ -547,10 +974,13 @@ bool PropertyGridPrivate::setPropertyValue(const PropertyContext &context, const
     if (internal::getVariantTypeId(value) != property.type() && !internal::canConvert(value, property.type()))
         return false;
 
-    internal::PropertyGridTreeItem *propertyItem = m_model.getPropertyItem(property.name());
+    // elements of containers don't have unique names, they are found through their context
+    internal::PropertyGridTreeItem *propertyItem = m_model.getNestedItem(context);
+    if (propertyItem == nullptr)
+        propertyItem = m_model.getPropertyItem(property.name());
 
     if (propertyItem == nullptr)
-        return false;
+        return setPendingPropertyValue(property.name(), value);
 
     const QModelIndex index = m_model.getItemIndex(propertyItem);
 
@@ -559,6 +989,322 @@ bool PropertyGridPrivate::setPropertyValue(const PropertyContext &context, const
     return true;
 }
 
+bool PropertyGridPrivate::setPendingPropertyValue(const QString &propertyName, const QVariant &value)
+{
+    // properties of categories that weren't fetched yet have no item, the value is kept in their context until then
+    PropertyContext *context = m_model.getPendingPropertyContext(propertyName);
+
+    if (context == nullptr)
+        return false;
+
+    const bool valueChanged = context->value() != value;
+
+    PropertyContextPrivate::setValue(*context, value);
+    m_model.refreshPendingProperty(propertyName);
+
+    if (!valueChanged)
+        return true;
+
+    emit q->propertyValueChanged(*context);
+
+    updateComputedProperties(propertyName);
+
+    return true;
+}
+
+bool PropertyGridPrivate::exportValues(QIODevice *device, PropertyGrid::ValuesFormat format, PropertyGrid::ValuesExportMode mode,
+                                       QString *errorMessage) const
+{
+    const internal::TraceSpan span("PropertyGrid::exportValues");
+
+    if (device == nullptr || !device->isWritable())
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = "the device isn't open for writing";
+
+        return false;
+    }
+
+    internal::PropertyValuesWriter writer(device, format);
+    QString unserializableProperty;
+
+    // NOTE: the contexts get visited where they are, none of the properties or their names get copied
+    const bool isComplete = forEachPropertyContext(m_model.rootItem(),
+                                                   [&](const PropertyContext &context)
+                                                   {
+                                                       const Property &property = context.property();
+
+                                                       if (mode == PropertyGrid::ValuesExportMode::ModifiedOnly &&
+                                                           internal::isDefaultValue(property, context.value()))
+                                                           return true;
+
+                                                       if (format == PropertyGrid::ValuesFormat::Text)
+                                                       {
+                                                           writer.writeText(property.name(), getEditorForProperty(context)->toString(context));
+                                                           return true;
+                                                       }
+
+                                                       if (writer.writeValue(property.name(), context.value()))
+                                                           return true;
+
+                                                       unserializableProperty = property.name();
+                                                       return false;
+                                                   });
+
+    if (!isComplete)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = QString("the value of property \"%1\" can't be serialized").arg(unserializableProperty);
+
+        return false;
+    }
+
+    return writer.finish(errorMessage);
+}
+
+bool PropertyGridPrivate::importValues(QIODevice *device, PropertyGrid::ValuesFormat format, QString *errorMessage)
+{
+    const internal::TraceSpan span("PropertyGrid::importValues");
+
+    if (device == nullptr || !device->isReadable())
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = "the device isn't open for reading";
+
+        return false;
+    }
+
+    // all the values get read before any of them is applied, a malformed file leaves the grid as it was
+    internal::PropertyValuesReader reader(device, format);
+    std::vector<std::pair<PropertyContext *, QVariant>> values;
+
+    QString name;
+    QString text;
+    QVariant value;
+
+    while (reader.readNext(name, text, value))
+    {
+        PropertyContext *context = findPropertyContext(name);
+        if (context == nullptr)
+            continue;
+
+        if (format == PropertyGrid::ValuesFormat::Text)
+            value = getEditorForProperty(*context)->fromString(text, *context);
+
+        // values that don't fit their property are skipped, just like setPropertyValue() rejects them
+        const int typeId = context->property().type();
+        if (internal::getVariantTypeId(value) != typeId && !internal::canConvert(value, typeId))
+            continue;
+
+        values.emplace_back(context, value);
+    }
+
+    if (reader.hasError())
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = reader.errorString();
+
+        return false;
+    }
+
+    applyValues(values);
+
+    return true;
+}
+
+void PropertyGridPrivate::resetToDefaultValues(const QStringList &propertyNames)
+{
+    std::vector<std::pair<PropertyContext *, QVariant>> values;
+    values.reserve(propertyNames.size());
+
+    for (const QString &propertyName : propertyNames)
+    {
+        PropertyContext *context = findPropertyContext(propertyName);
+        if (context == nullptr || !context->property().hasAttribute<DefaultValueAttribute>())
+            continue;
+
+        values.emplace_back(context, context->property().getAttribute<DefaultValueAttribute>().value);
+    }
+
+    applyValues(values);
+}
+
+void PropertyGridPrivate::applyValues(const std::vector<std::pair<PropertyContext *, QVariant>> &values)
+{
+    const internal::TraceSpan span("PropertyGridPrivate::applyValues");
+
+    // a property that is given more than once ends up with its last value, and is only notified about once
+    std::vector<std::pair<PropertyContext *, QVariant>> lastValues;
+    QHash<const PropertyContext *, size_t> lastValuesIndices;
+
+    for (const auto &entry : values)
+    {
+        auto it = lastValuesIndices.constFind(entry.first);
+        if (it != lastValuesIndices.constEnd())
+        {
+            lastValues[it.value()].second = entry.second;
+            continue;
+        }
+
+        lastValuesIndices.insert(entry.first, lastValues.size());
+        lastValues.push_back(entry);
+    }
+
+    std::vector<internal::PropertyGridTreeItem *> items;
+    QStringList changedProperties;
+
+    for (const auto &entry : lastValues)
+    {
+        PropertyContext &context = *entry.first;
+        if (context.value() == entry.second)
+            continue;
+
+        // NOTE: the view only hands single-row notifications on to an open editor. it stays open when nothing changes
+        if (changedProperties.isEmpty())
+            closeEditor();
+
+        PropertyContextPrivate::setValue(context, entry.second);
+        changedProperties.append(context.property().name());
+
+        // pending properties only keep their value, their items get created from it
+        internal::PropertyGridTreeItem *item = m_model.getPropertyItem(context.property().name());
+        if (item == nullptr)
+        {
+            m_model.refreshPendingProperty(context.property().name());
+            continue;
+        }
+
+        updateItemData(item);
+        m_model.updateElements(item);
+
+        items.push_back(item);
+    }
+
+    m_model.notifyItemsDataChanged(items, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+    m_model.refreshPropertyRows(items);
+
+    // NOTE: the contexts are looked up again, the layout change may have fetched the categories of pending properties
+    for (const QString &propertyName : changedProperties)
+    {
+        const PropertyContext *context = findPropertyContext(propertyName);
+        if (context == nullptr)
+            continue;
+
+        if (m_recorder != nullptr)
+            m_recorder->recordSetValue(propertyName, context->value());
+
+        emit q->propertyValueChanged(*context);
+    }
+
+    for (const QString &propertyName : changedProperties)
+        updateComputedProperties(propertyName);
+}
+
+PropertyContext *PropertyGridPrivate::findPropertyContext(const QString &propertyName) const
+{
+    internal::PropertyGridTreeItem *propertyItem = m_model.getPropertyItem(propertyName);
+    if (propertyItem != nullptr)
+        return &propertyItem->context;
+
+    return m_model.getPendingPropertyContext(propertyName);
+}
+
+void PropertyGridPrivate::addComputedProperty(const PropertyContext &context)
+{
+    const Property &property = context.property();
+
+    // NOTE: only properties that others depend on are part of the graph without having dependencies of their own
+    if (!property.hasAttribute<DependsOnAttribute>())
+    {
+        updateComputedProperties(property.name());
+        return;
+    }
+
+    // duplicates get rejected by the model, their dependencies must not be registered either
+    const PropertyContext *addedContext = findPropertyContext(property.name());
+    if (addedContext == nullptr || !addedContext->property().hasAttribute<DependsOnAttribute>())
+        return;
+
+    if (!m_dependencyGraph.addProperty(property.name(), property.getAttribute<DependsOnAttribute>().dependencies))
+        return;
+
+    updateComputedProperties(property.name(), true);
+}
+
+void PropertyGridPrivate::updateComputedProperties(const QString &propertyName, bool includeSelf)
+{
+    // NOTE: properties that change while recomputing are dependents of the one being updated, the graph is already
+    //       taking care of them
+    if (m_isUpdatingComputedProperties)
+        return;
+
+    m_isUpdatingComputedProperties = true;
+    m_dependencyGraph.update(propertyName, includeSelf, [this](const QString &name) { return recomputeProperty(name); });
+    m_isUpdatingComputedProperties = false;
+}
+
+bool PropertyGridPrivate::recomputeProperty(const QString &propertyName)
+{
+    const PropertyContext *context = findPropertyContext(propertyName);
+
+    // properties can be referenced before they get added
+    if (context == nullptr || !context->property().hasAttribute<DependsOnAttribute>())
+        return false;
+
+    const DependsOnAttribute attribute = context->property().getAttribute<DependsOnAttribute>();
+
+    QVariantList values;
+    values.reserve(attribute.dependencies.size());
+
+    for (const QString &dependency : attribute.dependencies)
+    {
+        const PropertyContext *dependencyContext = findPropertyContext(dependency);
+        values.append(dependencyContext != nullptr ? dependencyContext->value() : QVariant());
+    }
+
+    ComputedState &state = m_computedStates[propertyName];
+    const ComputedState oldState = state;
+
+    if (attribute.isReadOnly)
+        state.isReadOnly = attribute.isReadOnly(values);
+
+    if (attribute.isVisible)
+        state.isVisible = attribute.isVisible(values);
+
+    internal::PropertyGridTreeItem *propertyItem = m_model.getPropertyItem(propertyName);
+    if (propertyItem != nullptr && (state.isReadOnly != oldState.isReadOnly || state.isVisible != oldState.isVisible))
+        updateComputedState(propertyItem);
+
+    if (!attribute.value)
+        return false;
+
+    const QVariant value = attribute.value(values);
+    if (value == context->value())
+        return false;
+
+    return setPropertyValue(*context, value);
+}
+
+void PropertyGridPrivate::updateComputedState(internal::PropertyGridTreeItem *item)
+{
+    const Property &property = item->context.property();
+    const ComputedState state = m_computedStates.value(property.name());
+    const bool readOnly = internal::isReadOnly(property) || state.isReadOnly;
+
+    Qt::ItemFlags flags = item->flags(1);
+    flags.setFlag(Qt::ItemIsEditable, !readOnly && internal::PropertyGridTreeItem::isEditableType(property.type()));
+    item->setFlags(1, flags);
+
+    const QVariant textColor = readOnly ? QVariant(q->palette().color(QPalette::Disabled, QPalette::Text)) : QVariant();
+    item->setColumnData(0, Qt::ForegroundRole, textColor);
+    item->setColumnData(1, Qt::ForegroundRole, textColor);
+
+    m_model.notifyItemDataChanged(item, 0, {Qt::ForegroundRole});
+    m_model.notifyItemDataChanged(item, 1, {Qt::ForegroundRole});
+
+    m_model.setItemHidden(item, !state.isVisible);
+}
+
 void PropertyGridPrivate::handleUiSelectionChange(const QModelIndex &current, const QModelIndex &previous)
 {
     ui->propertyDescriptionLabel->setText("");
@@ -576,27 +1322,66 @@ void PropertyGridPrivate::handleUiSelectionChange(const QModelIndex &current, co
     ui->propertyDescriptionLabel->setText(propertyDescription);
 }
 
+void PropertyGridPrivate::recordEdit(const PropertyContext &context)
+{
+    // edits of elements get recorded as the new value of the property they belong to
+    internal::PropertyGridTreeItem *item = m_model.getNestedItem(context);
+    if (item == nullptr)
+        item = m_model.getPropertyItem(context.property().name());
+
+    while (item != nullptr && item->isElement())
+        item = item->parent;
+
+    if (item != nullptr)
+        m_recorder->recordEdit(item->context.property().name(), item->context.value());
+}
+
 PropertyEditor *PropertyGridPrivate::getEditorForProperty(const PropertyContext &context) const
 {
     // TODO: in the future add the ability to have a special Attribute that can override the editor
 
     // NOTE: this function never returns nullptr
 
-    for (auto editor = m_propertyEditors.begin(); editor != m_propertyEditors.end(); ++editor)
-    {
-        if (editor->second->canHandle(context))
-            return editor->second.get();
-    }
+    m_model.counters().count(internal::PropertyGridCounters::EditorLookups);
+
+    PropertyEditor *result = internal::findPropertyEditor(m_propertyEditors, context);
 
     // if no editor knows how to handle this data, return the default one
-    return &defaultPropertyEditor();
+    if (result == nullptr)
+        return &defaultPropertyEditor();
+
+    return result;
+}
+
+internal::PropertyGridCounters::EditorCounters *PropertyGridPrivate::editorCounters(const PropertyEditor &editor) const
+{
+    if (!internal::PropertyGridCounters::isEnabled())
+        return nullptr;
+
+    // NOTE: no lock needed, this only ever gets called on the GUI thread
+    internal::PropertyGridCounters::EditorCounters *&result = m_editorCounters[&editor];
+    if (result == nullptr)
+        result = m_model.counters().editorCounters(editor);
+
+    return result;
 }
 
-QPixmap PropertyGridPrivate::generateDecoration(const QPixmap &pixmap)
+QPixmap PropertyGridPrivate::previewIcon(const PropertyEditor &editor, const PropertyContext &context)
+{
+    const internal::TraceSpan span("PropertyEditor::getPreviewIcon");
+
+    return editor.getPreviewIcon(context);
+}
+
+QPixmap PropertyGridPrivate::generateDecoration(const QPixmap &pixmap) const
 {
     if (pixmap.isNull())
         return pixmap;
 
+    const internal::TraceSpan span("PropertyGrid::generateDecoration");
+
+    m_model.counters().count(internal::PropertyGridCounters::DecorationRenders);
+
     QPixmap result(PROPERTY_EDITOR_DECORATION_WIDTH, PROPERTY_EDITOR_DECORATION_HEIGHT);
     result.fill(Qt::transparent);
     QPainter painter(&result);
@@ -624,6 +1409,49 @@ QPixmap PropertyGridPrivate::generateDecoration(const QPixmap &pixmap)
     return result;
 }
 
+internal::PropertyGridTreeBuilder PropertyGridPrivate::createTreeBuilder() const
+{
+    internal::PropertyGridTreeBuilder::Style style;
+    style.categoryFont = internal::PropertyGridTreeModel::categoryFont();
+    style.categoryBackgroundColor = internal::PropertyGridTreeModel::categoryBackgroundColor();
+    style.readOnlyTextColor = q->palette().color(QPalette::Disabled, QPalette::Text);
+
+    return internal::PropertyGridTreeBuilder(m_propertyEditors, &defaultPropertyEditor(), style);
+}
+
+void PropertyGridPrivate::installLoadedTree()
+{
+    internal::PropertyGridTreeSnapshot snapshot = m_treeLoader.takeSnapshot();
+
+    if (snapshot.rootItem == nullptr)
+        return;
+
+    // NOTE: the decorations are the only part that the worker thread isn't allowed to do, the model has them generated
+    //       for the rows that actually get shown, see loadItemDecoration()
+    for (internal::PropertyGridTreeItem *item : std::as_const(snapshot.propertiesMap))
+        PropertyContextPrivate::setPropertyGrid(item->context, q);
+
+    m_model.installTree(std::move(snapshot));
+
+    // the loaded properties replace all the previous ones, computed properties included
+    m_dependencyGraph.clear();
+    m_computedStates.clear();
+
+    for (internal::PropertyGridTreeItem *item : m_model.propertyItems())
+        addComputedProperty(item->context);
+
+    expandCategories();
+
+    emit q->propertiesLoaded();
+}
+
+void PropertyGridPrivate::loadItemDecoration(internal::PropertyGridTreeItem *item) const
+{
+    const QPixmap decoration = generateDecoration(previewIcon(*getEditorForProperty(item->context), item->context));
+
+    item->setColumnData(1, Qt::DecorationRole, decoration.isNull() ? QVariant() : QVariant(decoration));
+}
+
 PropertyGrid::PropertyGrid(QWidget *parent) : QWidget(parent), d(new PropertyGridPrivate(this))
 {
     d->ui->setupUi(this);
@@ -641,6 +1469,25 @@ PropertyGrid::PropertyGrid(QWidget *parent) : QWidget(parent), d(new PropertyGri
                 //
                 d->handleUiSelectionChange(current, previous);
             });
+
+    // the items of collapsed elements (containers, composites and objects) are released to keep huge graphs cheap
+    connect(d->ui->propertiesTreeView, &QTreeView::collapsed, this,
+            [this](const QModelIndex &index)
+            {
+                //
+                d->m_model.releaseElements(d->m_model.getItem(index));
+            });
+
+    connect(&d->m_treeLoader, &internal::PropertyGridTreeLoader::finished, this, [this]() { d->installLoadedTree(); });
+    connect(&d->m_populationTimer, &QTimer::timeout, this, [this]() { d->populateNextSlice(); });
+
+    // rows that got added, changed or scrolled away might put the grid over its memory budget
+    connect(&d->m_memoryBudgetTimer, &QTimer::timeout, this, [this]() { d->enforceMemoryBudget(); });
+    connect(&d->m_model, &QAbstractItemModel::rowsInserted, this, [this]() { d->scheduleMemoryBudgetCheck(); });
+    connect(&d->m_model, &QAbstractItemModel::dataChanged, this, [this]() { d->scheduleMemoryBudgetCheck(); });
+    connect(&d->m_model, &QAbstractItemModel::modelReset, this, [this]() { d->scheduleMemoryBudgetCheck(); });
+    connect(d->ui->propertiesTreeView, &QTreeView::collapsed, this, [this]() { d->scheduleMemoryBudgetCheck(); });
+    connect(d->ui->propertiesTreeView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { d->scheduleMemoryBudgetCheck(); });
 }
 
 PropertyGrid::~PropertyGrid()
@@ -650,31 +1497,17 @@ PropertyGrid::~PropertyGrid()
 
 void PropertyGrid::addProperty(const Property &property, const QVariant &value, void *object)
 {
-    // NEVER EVER allow any properties with empty names
-    if (property.name().isEmpty())
-        return;
+    const internal::TraceSpan span("PropertyGrid::addProperty", property.name());
 
-    // property name is a unique identifier. duplicates are not allowed
-    if (d->m_model.getPropertyItem(property.name()) != nullptr)
-    {
-        qWarning() << "property" << property.name() << "alrready exists!";
-        return;
-    }
-
-    PropertyContext context = PropertyContextPrivate::createContext(property, value, object, this);
-
-    QModelIndex propertyIndex = d->m_model.addProperty(context);
-
-    bool readOnly = property.hasAttribute<ReadOnlyAttribute>() && property.getAttribute<ReadOnlyAttribute>().value == true;
+    // NOTE: empty names and duplicates get rejected by the model
+    const PropertyContext context = PropertyContextPrivate::createContext(property, value, object, this);
+    d->m_model.addProperties({context});
+    d->addComputedProperty(context);
 
-    QColor disabledTextColor = palette().color(QPalette::Disabled, QPalette::Text);
-    if (readOnly)
-        d->m_model.setDataForAllColumns(propertyIndex, disabledTextColor, Qt::ForegroundRole);
+    if (d->m_recorder != nullptr)
+        d->m_recorder->recordAddProperty(property, value);
 
-    d->updatePropertyValue(propertyIndex, value);
-
-    if (d->m_model.showCategories())
-        d->ui->propertiesTreeView->expandToDepth(0);
+    d->expandCategories();
 }
 
 bool PropertyGrid::showCategories() const
@@ -685,6 +1518,41 @@ bool PropertyGrid::showCategories() const
 void PropertyGrid::setShowCategories(bool value)
 {
     d->m_model.setShowCategories(value);
+
+    if (d->m_recorder != nullptr)
+        d->m_recorder->recordShowCategories(value);
+}
+
+bool PropertyGrid::categoriesExpandedByDefault() const
+{
+    return d->m_model.categoriesExpandedByDefault();
+}
+
+void PropertyGrid::setCategoriesExpandedByDefault(bool value)
+{
+    d->m_model.setCategoriesExpandedByDefault(value);
+}
+
+QString PropertyGrid::filterText() const
+{
+    return d->m_model.filterText();
+}
+
+void PropertyGrid::setFilterText(const QString &text)
+{
+    d->m_model.setFilterText(text);
+
+    d->expandCategories();
+}
+
+PropertyGrid::SortMode PropertyGrid::sortMode() const
+{
+    return d->m_model.sortMode();
+}
+
+void PropertyGrid::setSortMode(SortMode mode)
+{
+    d->m_model.setSortMode(mode);
 }
 
 bool PropertyGrid::setPropertyValue(const QString &propertyName, const QVariant &value)
@@ -692,12 +1560,20 @@ bool PropertyGrid::setPropertyValue(const QString &propertyName, const QVariant
     if (propertyName.trimmed().isEmpty())
         return false;
 
+    bool result = false;
+
     internal::PropertyGridTreeItem *propertyItem = d->m_model.getPropertyItem(propertyName);
+    const PropertyContext *pendingContext = propertyItem == nullptr ? d->m_model.getPendingPropertyContext(propertyName) : nullptr;
 
-    if (propertyItem == nullptr)
-        return false;
+    if (propertyItem != nullptr)
+        result = d->setPropertyValue(propertyItem->context, value);
+    else if (pendingContext != nullptr)
+        result = d->setPropertyValue(*pendingContext, value);
+
+    if (result && d->m_recorder != nullptr)
+        d->m_recorder->recordSetValue(propertyName, value);
 
-    return d->setPropertyValue(propertyItem->context, value);
+    return result;
 }
 
 PropertyContext PropertyGrid::getPropertyContext(const QString &propertyName) const
@@ -707,12 +1583,165 @@ PropertyContext PropertyGrid::getPropertyContext(const QString &propertyName) co
     if (treeItem != nullptr)
         return treeItem->context;
 
+    const PropertyContext *pendingContext = d->m_model.getPendingPropertyContext(propertyName);
+    if (pendingContext != nullptr)
+        return *pendingContext;
+
     return PropertyContextPrivate::invalidContext();
 }
 
+bool PropertyGrid::exportValues(QIODevice *device, ValuesFormat format, ValuesExportMode mode, QString *errorMessage) const
+{
+    return d->exportValues(device, format, mode, errorMessage);
+}
+
+bool PropertyGrid::importValues(QIODevice *device, ValuesFormat format, QString *errorMessage)
+{
+    return d->importValues(device, format, errorMessage);
+}
+
+int PropertyGrid::modifiedPropertiesCount() const
+{
+    return d->m_model.modifiedPropertiesCount();
+}
+
+void PropertyGrid::forEachModifiedProperty(const std::function<void(const PropertyContext &)> &function) const
+{
+    d->m_model.forEachModifiedProperty(
+        [this, &function](const QString &propertyName)
+        {
+            //
+            function(*d->findPropertyContext(propertyName));
+        });
+}
+
+void PropertyGrid::resetToDefaultValues()
+{
+    // NOTE: only the modified properties get visited, the others already hold their default values
+    QStringList propertyNames;
+    propertyNames.reserve(d->m_model.modifiedPropertiesCount());
+
+    d->m_model.forEachModifiedProperty(
+        [&propertyNames](const QString &propertyName)
+        {
+            //
+            propertyNames.append(propertyName);
+        });
+
+    d->resetToDefaultValues(propertyNames);
+}
+
+void PropertyGrid::resetToDefaultValues(const QStringList &propertyNames)
+{
+    d->resetToDefaultValues(propertyNames);
+}
+
+void PropertyGrid::loadPropertiesAsync(PropertyList properties)
+{
+    // NOTE: the loader replaces whatever the grid shows, replaying the log loads the properties synchronously
+    if (d->m_recorder != nullptr)
+    {
+        d->m_recorder->recordClear();
+
+        for (const auto &entry : properties)
+            d->m_recorder->recordAddProperty(entry.first, entry.second);
+    }
+
+    d->m_treeLoader.start(d->createTreeBuilder(), std::move(properties));
+}
+
+bool PropertyGrid::isLoadingProperties() const
+{
+    return d->m_treeLoader.isRunning();
+}
+
+void PropertyGrid::populateProperties(const PropertyGenerator &generator, int timeBudgetMs)
+{
+    cancelPopulation();
+
+    if (!generator)
+        return;
+
+    d->m_populationGenerator = std::make_shared<PropertyGenerator>(generator);
+    d->m_populationTimeBudget = qMax(1, timeBudgetMs);
+    d->m_populatedCount = 0;
+
+    d->m_populationTimer.start();
+}
+
+void PropertyGrid::cancelPopulation()
+{
+    if (!isPopulating())
+        return;
+
+    d->finishPopulation(true);
+}
+
+bool PropertyGrid::isPopulating() const
+{
+    return d->m_populationGenerator != nullptr;
+}
+
+PropertyGridStatistics PropertyGrid::statistics() const
+{
+    return d->m_model.counters().statistics();
+}
+
+void PropertyGrid::resetStatistics()
+{
+    d->m_model.counters().reset();
+}
+
+PropertyGridMemoryUsage PropertyGrid::memoryUsage() const
+{
+    return d->memoryUsage();
+}
+
+quint64 PropertyGrid::memoryBudget() const
+{
+    return d->m_memoryBudget;
+}
+
+void PropertyGrid::setMemoryBudget(quint64 bytesCount)
+{
+    d->m_memoryBudget = bytesCount;
+
+    if (bytesCount == 0)
+        d->m_memoryBudgetTimer.stop();
+    else
+        d->enforceMemoryBudget();
+}
+
+void PropertyGrid::setTracingEnabled(bool value)
+{
+    internal::PropertyGridTracer::setEnabled(value);
+}
+
+bool PropertyGrid::isTracingEnabled()
+{
+    return internal::PropertyGridTracer::isEnabled();
+}
+
+void PropertyGrid::clearTrace()
+{
+    internal::PropertyGridTracer::clear();
+}
+
+QByteArray PropertyGrid::traceJson()
+{
+    return internal::PropertyGridTracer::toChromeTraceJson();
+}
+
 void PropertyGrid::clearProperties()
 {
+    cancelPopulation();
+    d->m_treeLoader.cancel();
     d->m_model.clearModel();
+    d->m_dependencyGraph.clear();
+    d->m_computedStates.clear();
+
+    if (d->m_recorder != nullptr)
+        d->m_recorder->recordClear();
 }
 
 QStringList PropertyGrid::propertyNames() const
@@ -729,6 +1758,7 @@ void PropertyGrid::replacePropertyEditor_impl(TypeId oldEditorTypeId, TypeId new
     }
 
     d->m_propertyEditors.erase(oldEditorTypeId);
+    d->m_editorCounters.clear(); // the address of the editor that went away may be taken by another one
 
     // no need to add a new instance of the default property editor if the user specified it explicitly
     if (newEditorTypeId == internal::getTypeId<PropertyEditor>())
@@ -746,13 +1776,11 @@ void PropertyGrid::addPropertyEditor_impl(TypeId typeId, std::shared_ptr<Propert
     d->m_propertyEditors.emplace(typeId, std::move(editor));
 
     // Force all property entries in the view to get calculated using the updated editors list
-    const QStringList names = propertyNames();
-    for (const QString &propertyName : names)
+    // NOTE: pending properties don't have any item yet, they pick up the new editor when their category is fetched
+    for (internal::PropertyGridTreeItem *item : std::as_const(d->m_model.propertyItems()))
     {
-        const PropertyContext context = getPropertyContext(propertyName);
-        internal::PropertyGridTreeItem *item = d->m_model.getPropertyItem(propertyName);
         const QModelIndex propertyIndex = d->m_model.getItemIndex(item);
 
-        d->updatePropertyValue(propertyIndex, context.value());
+        d->updatePropertyValue(propertyIndex, item->context.value());
     }
 }
@@ -2,10 +2,14 @@
 #define PROPERTYGRID_H
 
 #include "PropertyEditor.h"
+#include "PropertyGridMemoryUsage.h"
+#include "PropertyGridStatistics.h"
 #include "QtCompat_p.h"
 
 #include <QDebug>
 
+class QIODevice;
+
 // TODO: add support for Dark mode and themes of other Operating systems
 //        refer to: https://www.qt.io/blog/dark-mode-on-windows-11-with-qt-6.5
 
@@ -13,12 +17,40 @@ namespace PM
 {
 class PropertyGridPrivate;
 
+using PropertyList = std::vector<std::pair<Property, QVariant>>;
+
+// fills in the next property and its value, returns false once there are no more properties
+using PropertyGenerator = std::function<bool(Property &property, QVariant &value)>;
+
 class PropertyGrid : public QWidget
 {
     Q_OBJECT
 
     friend class PM::PropertyGridPrivate;
 
+public:
+    // The order of the rows, changing it only moves the existing rows around
+    enum class SortMode
+    {
+        InsertionOrder,
+        CategoryOrder, // categories sorted by name, their properties in insertion order
+        NameOrder,
+        ValueOrder, // numbers by value, anything else by its displayed text
+    };
+
+    // How exportValues() writes the values, importValues() has to be given the same format
+    enum class ValuesFormat
+    {
+        Text,   // a "name<TAB>value" line per property, the values as PropertyEditor::toString() shows them
+        Binary, // the values as they are, through QDataStream
+    };
+
+    enum class ValuesExportMode
+    {
+        AllValues,
+        ModifiedOnly, // skips the properties that hold the value of their DefaultValueAttribute
+    };
+
 public:
     explicit PropertyGrid(QWidget *parent = nullptr);
     ~PropertyGrid();
@@ -40,10 +72,72 @@ public:
     bool showCategories() const;
     void setShowCategories(bool value);
 
+    // When disabled, new categories start collapsed and their properties only get created once they are expanded
+    bool categoriesExpandedByDefault() const;
+    void setCategoriesExpandedByDefault(bool value);
+
+    // Only shows the properties whose name, description or displayed value contains the text (case insensitive)
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+    SortMode sortMode() const;
+    void setSortMode(SortMode mode);
+
     bool setPropertyValue(const QString &propertyName, const QVariant &value);
 
     PropertyContext getPropertyContext(const QString &propertyName) const;
 
+    // Writes the values of all the properties, those of categories that weren't fetched yet included, straight to the device
+    // in the order of the tree. Fails on write errors, as well as on values that QDataStream can't serialize (Binary only).
+    bool exportValues(QIODevice *device, ValuesFormat format, ValuesExportMode mode = ValuesExportMode::AllValues,
+                      QString *errorMessage = nullptr) const;
+    // Reads the values written by exportValues() and applies them in one batch, nothing gets applied when any of them
+    // can't be read. The values of properties the grid doesn't have are ignored.
+    bool importValues(QIODevice *device, ValuesFormat format, QString *errorMessage = nullptr);
+
+    // Properties with a DefaultValueAttribute count as modified while they hold another value, their values are shown in bold.
+    // The states are kept up to date as the values change, counting the modified properties doesn't visit any of them.
+    int modifiedPropertiesCount() const;
+    // NOTE: the grid must not be changed from within the function
+    void forEachModifiedProperty(const std::function<void(const PropertyContext &context)> &function) const;
+    // Sets the properties back to the values of their DefaultValueAttribute in one batch, like importValues() does.
+    // Properties without a default value are left as they are.
+    void resetToDefaultValues();
+    void resetToDefaultValues(const QStringList &propertyNames);
+
+    // Replaces all the properties of the grid with the given ones. The tree gets built on a worker thread and
+    // installed in one go once it's ready, propertiesLoaded() gets emitted after that.
+    // NOTE: toString() of the property editors gets called from the worker thread, custom editors must be reentrant
+    void loadPropertiesAsync(PropertyList properties);
+    bool isLoadingProperties() const;
+
+    // Adds the properties produced by the generator on the GUI thread, spending at most timeBudgetMs per event-loop turn.
+    // Starting another population or clearing the grid cancels the one in progress.
+    void populateProperties(const PropertyGenerator &generator, int timeBudgetMs = 4);
+    void cancelPopulation();
+    bool isPopulating() const;
+
+    // Cumulative counters and timings since the grid got created or the statistics got reset, see PropertyGridStatistics
+    PropertyGridStatistics statistics() const;
+    void resetStatistics();
+
+    // Estimated memory footprint of the grid, broken down by what holds it, see PropertyGridMemoryUsage
+    PropertyGridMemoryUsage memoryUsage() const;
+
+    // Once the estimated footprint goes over the budget, the displayed texts and decorations of the rows that aren't on
+    // screen (scrolled away or in collapsed categories) get evicted, least recently shown first. They are generated
+    // again when the rows get shown. 0, the default, means no budget.
+    quint64 memoryBudget() const;
+    void setMemoryBudget(quint64 bytesCount);
+
+    // Records the grid operations of the whole process as spans in a ring buffer, the oldest ones get dropped once it's full.
+    // Only available when the library is built with PM_PROPERTY_GRID_ENABLE_TRACING, isTracingEnabled() is false otherwise.
+    static void setTracingEnabled(bool value);
+    static bool isTracingEnabled();
+    static void clearTrace();
+    // the recorded spans as Chrome trace-event JSON, opens in chrome://tracing or https://ui.perfetto.dev
+    static QByteArray traceJson();
+
 public: /* EXPERIMENTAL API */
     /**/
     template <typename OldEditor, typename NewEditor,
@@ -59,6 +153,10 @@ public: /* EXPERIMENTAL API */
 
 signals:
     void propertyValueChanged(const PM::PropertyContext &context);
+    void propertiesLoaded();
+
+    void populationProgress(int addedPropertiesCount);
+    void populationFinished(bool cancelled);
 
 private: // stable internal functions
     void replacePropertyEditor_impl(TypeId oldEditorTypeId, TypeId newEditorTypeId, std::shared_ptr<PropertyEditor> &&editor);
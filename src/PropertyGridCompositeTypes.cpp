@@ -0,0 +1,231 @@
+#include "PropertyGridCompositeTypes_p.h"
+
+#include "QtCompat_p.h"
+
+#include <QMetaProperty>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QVector2D>
+#include <QVector3D>
+#include <QVector4D>
+
+#include <memory>
+#include <unordered_map>
+
+using namespace PM;
+
+namespace
+{
+template <typename T, typename Getter, typename Setter>
+internal::CompositeTypePlan::Field createField(const char *name, Getter getter, Setter setter)
+{
+    using FieldType = typename std::decay<decltype((std::declval<const T &>().*getter)())>::type;
+
+    internal::CompositeTypePlan::Field result;
+    result.name = name;
+    result.typeId = qMetaTypeId<FieldType>();
+    result.read = [getter](const QVariant &compositeValue)
+    {
+        //
+        return QVariant::fromValue((compositeValue.value<T>().*getter)());
+    };
+    result.write = [setter](QVariant &compositeValue, const QVariant &fieldValue)
+    {
+        T composite = compositeValue.value<T>();
+        (composite.*setter)(fieldValue.value<FieldType>());
+
+        compositeValue = QVariant::fromValue(composite);
+    };
+
+    return result;
+}
+
+std::unique_ptr<internal::CompositeTypePlan> createBuiltinPlan(int typeId)
+{
+    std::unique_ptr<internal::CompositeTypePlan> result = std::make_unique<internal::CompositeTypePlan>();
+    std::vector<internal::CompositeTypePlan::Field> &fields = result->fields;
+
+    // NOTE: x and y of rectangles move them, just like in Qt Designer, instead of moving only one of their edges
+    if (typeId == qMetaTypeId<QPoint>())
+    {
+        fields.push_back(createField<QPoint>("x", &QPoint::x, &QPoint::setX));
+        fields.push_back(createField<QPoint>("y", &QPoint::y, &QPoint::setY));
+    }
+    else if (typeId == qMetaTypeId<QPointF>())
+    {
+        fields.push_back(createField<QPointF>("x", &QPointF::x, &QPointF::setX));
+        fields.push_back(createField<QPointF>("y", &QPointF::y, &QPointF::setY));
+    }
+    else if (typeId == qMetaTypeId<QSize>())
+    {
+        fields.push_back(createField<QSize>("width", &QSize::width, &QSize::setWidth));
+        fields.push_back(createField<QSize>("height", &QSize::height, &QSize::setHeight));
+    }
+    else if (typeId == qMetaTypeId<QSizeF>())
+    {
+        fields.push_back(createField<QSizeF>("width", &QSizeF::width, &QSizeF::setWidth));
+        fields.push_back(createField<QSizeF>("height", &QSizeF::height, &QSizeF::setHeight));
+    }
+    else if (typeId == qMetaTypeId<QRect>())
+    {
+        fields.push_back(createField<QRect>("x", &QRect::x, &QRect::moveLeft));
+        fields.push_back(createField<QRect>("y", &QRect::y, &QRect::moveTop));
+        fields.push_back(createField<QRect>("width", &QRect::width, &QRect::setWidth));
+        fields.push_back(createField<QRect>("height", &QRect::height, &QRect::setHeight));
+    }
+    else if (typeId == qMetaTypeId<QRectF>())
+    {
+        fields.push_back(createField<QRectF>("x", &QRectF::x, &QRectF::moveLeft));
+        fields.push_back(createField<QRectF>("y", &QRectF::y, &QRectF::moveTop));
+        fields.push_back(createField<QRectF>("width", &QRectF::width, &QRectF::setWidth));
+        fields.push_back(createField<QRectF>("height", &QRectF::height, &QRectF::setHeight));
+    }
+    else if (typeId == qMetaTypeId<QVector2D>())
+    {
+        fields.push_back(createField<QVector2D>("x", &QVector2D::x, &QVector2D::setX));
+        fields.push_back(createField<QVector2D>("y", &QVector2D::y, &QVector2D::setY));
+    }
+    else if (typeId == qMetaTypeId<QVector3D>())
+    {
+        fields.push_back(createField<QVector3D>("x", &QVector3D::x, &QVector3D::setX));
+        fields.push_back(createField<QVector3D>("y", &QVector3D::y, &QVector3D::setY));
+        fields.push_back(createField<QVector3D>("z", &QVector3D::z, &QVector3D::setZ));
+    }
+    else if (typeId == qMetaTypeId<QVector4D>())
+    {
+        fields.push_back(createField<QVector4D>("x", &QVector4D::x, &QVector4D::setX));
+        fields.push_back(createField<QVector4D>("y", &QVector4D::y, &QVector4D::setY));
+        fields.push_back(createField<QVector4D>("z", &QVector4D::z, &QVector4D::setZ));
+        fields.push_back(createField<QVector4D>("w", &QVector4D::w, &QVector4D::setW));
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    return result;
+}
+
+std::unique_ptr<internal::CompositeTypePlan> createGadgetPlan(int typeId)
+{
+    if (!internal::isGadgetType(typeId))
+        return nullptr;
+
+    const QMetaObject *metaObject = internal::getMetaObjectForType(typeId);
+    if (metaObject == nullptr || metaObject->propertyCount() == 0)
+        return nullptr;
+
+    std::unique_ptr<internal::CompositeTypePlan> result = std::make_unique<internal::CompositeTypePlan>();
+
+    for (int i = 0; i < metaObject->propertyCount(); ++i)
+    {
+        const QMetaProperty metaProperty = metaObject->property(i);
+
+        internal::CompositeTypePlan::Field field;
+        field.name = metaProperty.name();
+        field.typeId = metaProperty.userType();
+
+        // NOTE: the gadget is accessed through a raw pointer to the value, which has to hold the type of the plan
+        field.read = [metaProperty, typeId](const QVariant &compositeValue)
+        {
+            if (compositeValue.userType() != typeId)
+                return QVariant();
+
+            return metaProperty.readOnGadget(compositeValue.constData());
+        };
+
+        if (metaProperty.isWritable())
+        {
+            field.write = [metaProperty, typeId](QVariant &compositeValue, const QVariant &fieldValue)
+            {
+                if (compositeValue.userType() != typeId)
+                    return;
+
+                metaProperty.writeOnGadget(compositeValue.data(), fieldValue);
+            };
+        }
+
+        result->fields.push_back(std::move(field));
+    }
+
+    return result;
+}
+std::unique_ptr<internal::CompositeTypePlan> createObjectPlan(const QMetaObject *metaObject)
+{
+    std::unique_ptr<internal::CompositeTypePlan> result = std::make_unique<internal::CompositeTypePlan>();
+
+    for (int i = 0; i < metaObject->propertyCount(); ++i)
+    {
+        const QMetaProperty metaProperty = metaObject->property(i);
+        if (!metaProperty.isReadable())
+            continue;
+
+        internal::CompositeTypePlan::Field field;
+        field.name = metaProperty.name();
+        field.typeId = metaProperty.userType();
+        field.read = [metaProperty](const QVariant &compositeValue)
+        {
+            const QObject *object = compositeValue.value<QObject *>();
+
+            return object != nullptr ? metaProperty.read(object) : QVariant();
+        };
+
+        // NOTE: objects are referenced by the value, writing a field doesn't change the value itself
+        if (metaProperty.isWritable())
+        {
+            field.write = [metaProperty](QVariant &compositeValue, const QVariant &fieldValue)
+            {
+                QObject *object = compositeValue.value<QObject *>();
+
+                if (object != nullptr)
+                    metaProperty.write(object, fieldValue);
+            };
+        }
+
+        result->fields.push_back(std::move(field));
+    }
+
+    return result;
+}
+
+QMutex &compositeTypePlansMutex()
+{
+    static QMutex result;
+
+    return result;
+}
+} // namespace
+
+const internal::CompositeTypePlan *internal::getObjectTypePlan(const QMetaObject *metaObject)
+{
+    static std::unordered_map<const QMetaObject *, std::unique_ptr<CompositeTypePlan>> plans;
+
+    QMutexLocker locker(&compositeTypePlansMutex());
+
+    auto it = plans.find(metaObject);
+    if (it != plans.end())
+        return it->second.get();
+
+    return plans.emplace(metaObject, createObjectPlan(metaObject)).first->second.get();
+}
+
+const internal::CompositeTypePlan *internal::getCompositeTypePlan(int typeId)
+{
+    // NOTE: types that can't be decomposed are cached as well, so that their metadata is only inspected once
+    static std::unordered_map<int, std::unique_ptr<CompositeTypePlan>> plans;
+
+    QMutexLocker locker(&compositeTypePlansMutex());
+
+    auto it = plans.find(typeId);
+    if (it != plans.end())
+        return it->second.get();
+
+    std::unique_ptr<CompositeTypePlan> plan = createBuiltinPlan(typeId);
+    if (plan == nullptr)
+        plan = createGadgetPlan(typeId);
+
+    return plans.emplace(typeId, std::move(plan)).first->second.get();
+}
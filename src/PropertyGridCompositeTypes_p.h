@@ -0,0 +1,51 @@
+#ifndef PROPERTYGRIDCOMPOSITETYPES_P_H
+#define PROPERTYGRIDCOMPOSITETYPES_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QMetaObject>
+#include <QString>
+#include <QVariant>
+
+#include <functional>
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // Describes how the value of a composite type (QSize, QRect, Q_GADGETs, ...) gets split into fields.
+    // A plan is built once per type, reading and writing fields never goes through the meta-object system again.
+    //
+    struct CompositeTypePlan
+    {
+        struct Field
+        {
+            QString name;
+            int typeId;
+
+            std::function<QVariant(const QVariant &compositeValue)> read;
+            std::function<void(QVariant &compositeValue, const QVariant &fieldValue)> write; // empty for read-only fields
+        };
+
+        std::vector<Field> fields;
+    };
+
+    // NOTE: returns nullptr for types that can't be decomposed, plans are never destroyed and this function is thread-safe
+    const CompositeTypePlan *getCompositeTypePlan(int typeId);
+
+    // the fields of QObjects are their properties, the values of these plans hold pointers to the objects
+    const CompositeTypePlan *getObjectTypePlan(const QMetaObject *metaObject);
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDCOMPOSITETYPES_P_H
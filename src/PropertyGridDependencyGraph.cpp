@@ -0,0 +1,171 @@
+#include "PropertyGridDependencyGraph_p.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+using namespace PM;
+
+bool internal::PropertyGridDependencyGraph::addProperty(const QString &propertyName, const QStringList &dependencies)
+{
+    const int id = nodeId(propertyName);
+
+    if (!m_nodes[id].dependencies.empty())
+    {
+        qWarning() << "property" << propertyName << "already has dependencies!";
+        return false;
+    }
+
+    std::vector<int> dependencyIds;
+    dependencyIds.reserve(dependencies.size());
+
+    for (const QString &dependency : dependencies)
+    {
+        const int dependencyId = nodeId(dependency);
+
+        // the new edges go from the dependencies to the property, they close a cycle if the property already reaches one of them
+        if (isReachable(id, dependencyId))
+        {
+            qWarning() << "property" << propertyName << "can't depend on" << dependency << "without creating a cycle!";
+            return false;
+        }
+
+        if (std::find(dependencyIds.begin(), dependencyIds.end(), dependencyId) == dependencyIds.end())
+            dependencyIds.push_back(dependencyId);
+    }
+
+    for (int dependencyId : dependencyIds)
+        m_nodes[dependencyId].dependents.push_back(id);
+
+    m_nodes[id].dependencies = std::move(dependencyIds);
+
+    return true;
+}
+
+void internal::PropertyGridDependencyGraph::clear()
+{
+    m_ids.clear();
+    m_nodes.clear();
+    m_marks.clear();
+    m_inDegrees.clear();
+    m_dirty.clear();
+    m_generation = 0;
+}
+
+bool internal::PropertyGridDependencyGraph::contains(const QString &propertyName) const
+{
+    return m_ids.contains(propertyName);
+}
+
+void internal::PropertyGridDependencyGraph::update(const QString &propertyName, bool includeSelf, const RecomputeFunction &recompute)
+{
+    auto it = m_ids.constFind(propertyName);
+    if (it == m_ids.constEnd())
+        return;
+
+    const int rootId = it.value();
+
+    // 1. collect the affected nodes, counting how many of their dependencies are affected as well
+    nextGeneration();
+
+    std::vector<int> affectedIds = {rootId};
+    m_marks[rootId] = m_generation;
+    m_inDegrees[rootId] = 0;
+    m_dirty[rootId] = includeSelf;
+
+    for (size_t i = 0; i < affectedIds.size(); ++i)
+    {
+        for (int dependentId : m_nodes[affectedIds[i]].dependents)
+        {
+            if (m_marks[dependentId] != m_generation)
+            {
+                m_marks[dependentId] = m_generation;
+                m_inDegrees[dependentId] = 0;
+                m_dirty[dependentId] = false;
+                affectedIds.push_back(dependentId);
+            }
+
+            m_inDegrees[dependentId]++;
+        }
+    }
+
+    // 2. visit them in topological order, the dependents of a node only become dirty when the node has changed
+    std::vector<int> readyIds = {rootId};
+
+    while (!readyIds.empty())
+    {
+        const int id = readyIds.back();
+        readyIds.pop_back();
+
+        // NOTE: the root itself has changed already, unless it's the one being recomputed
+        const bool changed = (id == rootId && !includeSelf) || (m_dirty[id] && recompute(m_nodes[id].name));
+
+        for (int dependentId : m_nodes[id].dependents)
+        {
+            if (changed)
+                m_dirty[dependentId] = true;
+
+            if (--m_inDegrees[dependentId] == 0)
+                readyIds.push_back(dependentId);
+        }
+    }
+}
+
+int internal::PropertyGridDependencyGraph::nodeId(const QString &propertyName)
+{
+    auto it = m_ids.constFind(propertyName);
+    if (it != m_ids.constEnd())
+        return it.value();
+
+    const int id = int(m_nodes.size());
+
+    m_ids.insert(propertyName, id);
+    m_nodes.push_back({propertyName, {}, {}});
+
+    m_marks.push_back(0);
+    m_inDegrees.push_back(0);
+    m_dirty.push_back(false);
+
+    return id;
+}
+
+bool internal::PropertyGridDependencyGraph::isReachable(int from, int to)
+{
+    if (from == to)
+        return true;
+
+    nextGeneration();
+
+    std::vector<int> pendingIds = {from};
+    m_marks[from] = m_generation;
+
+    while (!pendingIds.empty())
+    {
+        const int id = pendingIds.back();
+        pendingIds.pop_back();
+
+        for (int dependentId : m_nodes[id].dependents)
+        {
+            if (dependentId == to)
+                return true;
+
+            if (m_marks[dependentId] == m_generation)
+                continue;
+
+            m_marks[dependentId] = m_generation;
+            pendingIds.push_back(dependentId);
+        }
+    }
+
+    return false;
+}
+
+void internal::PropertyGridDependencyGraph::nextGeneration()
+{
+    // NOTE: on wrap around the stale marks could collide with the new generation, so they all get reset once
+    if (++m_generation == 0)
+    {
+        std::fill(m_marks.begin(), m_marks.end(), 0);
+        m_generation = 1;
+    }
+}
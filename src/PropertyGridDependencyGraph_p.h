@@ -0,0 +1,74 @@
+#ifndef PROPERTYGRIDDEPENDENCYGRAPH_P_H
+#define PROPERTYGRIDDEPENDENCYGRAPH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // The dependencies between computed properties (see DependsOnAttribute) and the properties they are computed from.
+    // Properties are identified by name, a property that is referenced before being added simply has no dependencies yet.
+    //
+    // An update only walks the properties that are reachable from the changed one, in topological order, and a property
+    // only gets recomputed when one of its dependencies actually changed. that's O(affected) per edit.
+    //
+    class PropertyGridDependencyGraph
+    {
+    public:
+        // recomputes a property, returns true if its value has changed
+        using RecomputeFunction = std::function<bool(const QString &propertyName)>;
+
+    public:
+        // NOTE: fails (and adds nothing) if the dependencies would create a cycle, or if the property already has dependencies
+        bool addProperty(const QString &propertyName, const QStringList &dependencies);
+        void clear();
+
+        bool contains(const QString &propertyName) const;
+
+        // recomputes everything that depends on the given property, and the property itself when includeSelf is true
+        void update(const QString &propertyName, bool includeSelf, const RecomputeFunction &recompute);
+
+    private:
+        struct Node
+        {
+            QString name;
+            std::vector<int> dependencies;
+            std::vector<int> dependents;
+        };
+
+        int nodeId(const QString &propertyName);
+        bool isReachable(int from, int to);
+        void nextGeneration();
+
+    private:
+        QHash<QString, int> m_ids;
+        std::vector<Node> m_nodes;
+
+        // scratch space of the graph walks, a node belongs to the current walk when its mark equals m_generation.
+        // that way nothing needs to be reset between two walks
+        std::vector<quint32> m_marks;
+        std::vector<int> m_inDegrees;
+        std::vector<bool> m_dirty;
+        quint32 m_generation = 0;
+    };
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDDEPENDENCYGRAPH_P_H
@@ -0,0 +1,256 @@
+#include "PropertyGridFilterIndex_p.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+// queries shorter than a trigram can't use the index, they get checked against every text instead
+const int FILTER_INDEX_TRIGRAM_LENGTH = 3;
+
+quint64 trigramKey(const QChar *characters)
+{
+    return (quint64(characters[0].unicode()) << 32) | (quint64(characters[1].unicode()) << 16) | quint64(characters[2].unicode());
+}
+} // namespace
+
+using namespace PM;
+
+int internal::PropertyGridFilterIndex::addText(const QString &text)
+{
+    const int id = int(m_texts.size());
+
+    m_texts.push_back(text.toCaseFolded());
+    m_matches.push_back(false);
+
+    std::vector<quint64> trigrams;
+    appendTrigrams(m_texts.back(), trigrams);
+
+    for (quint64 trigram : trigrams)
+        m_trigrams[trigram].push_back(id);
+
+    if (isActive() && textMatches(id))
+    {
+        m_matches[id] = true;
+        m_matchingIds.push_back(id);
+    }
+
+    return id;
+}
+
+void internal::PropertyGridFilterIndex::setText(int id, const QString &text)
+{
+    QString foldedText = text.toCaseFolded();
+    if (foldedText == m_texts[id])
+        return;
+
+    std::vector<quint64> oldTrigrams;
+    appendTrigrams(m_texts[id], oldTrigrams);
+
+    std::vector<quint64> newTrigrams;
+    appendTrigrams(foldedText, newTrigrams);
+
+    // the trigrams both texts have keep their postings, only the ones that got dropped or added are touched
+    std::vector<quint64> removedTrigrams;
+    std::set_difference(oldTrigrams.begin(), oldTrigrams.end(), newTrigrams.begin(), newTrigrams.end(), std::back_inserter(removedTrigrams));
+
+    std::vector<quint64> addedTrigrams;
+    std::set_difference(newTrigrams.begin(), newTrigrams.end(), oldTrigrams.begin(), oldTrigrams.end(), std::back_inserter(addedTrigrams));
+
+    for (quint64 trigram : removedTrigrams)
+    {
+        auto it = m_trigrams.find(trigram);
+        if (it == m_trigrams.end())
+            continue;
+
+        std::vector<int> &ids = it.value();
+
+        // NOTE: the order of the ids doesn't matter, the last one takes the place of the removed one
+        auto idIt = std::find(ids.begin(), ids.end(), id);
+        if (idIt != ids.end())
+        {
+            *idIt = ids.back();
+            ids.pop_back();
+        }
+
+        if (ids.empty())
+            m_trigrams.erase(it);
+    }
+
+    for (quint64 trigram : addedTrigrams)
+        m_trigrams[trigram].push_back(id);
+
+    m_texts[id] = std::move(foldedText);
+
+    if (!isActive())
+        return;
+
+    const bool matches = textMatches(id);
+    if (matches == m_matches[id])
+        return;
+
+    m_matches[id] = matches;
+
+    if (matches)
+        m_matchingIds.push_back(id);
+    else
+        m_matchingIds.erase(std::find(m_matchingIds.begin(), m_matchingIds.end(), id));
+}
+
+void internal::PropertyGridFilterIndex::clear()
+{
+    m_texts.clear();
+    m_trigrams.clear();
+    m_matches.clear();
+    m_matchingIds.clear();
+}
+
+int internal::PropertyGridFilterIndex::count() const
+{
+    return int(m_texts.size());
+}
+
+const QString &internal::PropertyGridFilterIndex::query() const
+{
+    return m_query;
+}
+
+bool internal::PropertyGridFilterIndex::isActive() const
+{
+    return !m_query.isEmpty();
+}
+
+void internal::PropertyGridFilterIndex::setQuery(const QString &query, std::vector<int> *changedIds)
+{
+    const QString foldedQuery = query.toCaseFolded();
+    if (foldedQuery == m_query)
+        return;
+
+    const bool wasActive = isActive();
+    const bool isNarrowing = wasActive && foldedQuery.contains(m_query);
+
+    std::vector<int> previousMatchingIds;
+    previousMatchingIds.swap(m_matchingIds);
+
+    m_query = foldedQuery;
+
+    if (isActive())
+    {
+        // every text that contains the new query also contains the previous one, so only the previous matches are candidates
+        if (isNarrowing)
+        {
+            for (int id : previousMatchingIds)
+            {
+                if (textMatches(id))
+                    m_matchingIds.push_back(id);
+            }
+        }
+        else if (m_query.size() >= FILTER_INDEX_TRIGRAM_LENGTH)
+        {
+            // the rarest trigram of the query gives the smallest set of candidates
+            const std::vector<int> *candidates = nullptr;
+
+            std::vector<quint64> trigrams;
+            appendTrigrams(m_query, trigrams);
+
+            for (quint64 trigram : trigrams)
+            {
+                auto it = m_trigrams.constFind(trigram);
+                if (it == m_trigrams.constEnd())
+                {
+                    candidates = nullptr;
+                    break;
+                }
+
+                if (candidates == nullptr || it->size() < candidates->size())
+                    candidates = &it.value();
+            }
+
+            if (candidates != nullptr)
+            {
+                for (int id : *candidates)
+                {
+                    if (textMatches(id))
+                        m_matchingIds.push_back(id);
+                }
+            }
+        }
+        else
+        {
+            for (int id = 0; id < count(); ++id)
+            {
+                if (textMatches(id))
+                    m_matchingIds.push_back(id);
+            }
+        }
+    }
+
+    // NOTE: the flags still describe the previous query at this point. every text matches while there is no query
+    if (changedIds != nullptr)
+    {
+        if (wasActive && isActive())
+        {
+            for (int id : m_matchingIds)
+            {
+                if (!m_matches[id])
+                    changedIds->push_back(id);
+            }
+        }
+        else if (wasActive)
+        {
+            for (int id = 0; id < count(); ++id)
+            {
+                if (!m_matches[id])
+                    changedIds->push_back(id);
+            }
+        }
+    }
+
+    for (int id : previousMatchingIds)
+        m_matches[id] = false;
+
+    for (int id : m_matchingIds)
+        m_matches[id] = true;
+
+    if (changedIds != nullptr)
+    {
+        if (wasActive && isActive())
+        {
+            for (int id : previousMatchingIds)
+            {
+                if (!m_matches[id])
+                    changedIds->push_back(id);
+            }
+        }
+        else if (isActive())
+        {
+            for (int id = 0; id < count(); ++id)
+            {
+                if (!m_matches[id])
+                    changedIds->push_back(id);
+            }
+        }
+    }
+}
+
+bool internal::PropertyGridFilterIndex::matches(int id) const
+{
+    return !isActive() || m_matches[id];
+}
+
+void internal::PropertyGridFilterIndex::appendTrigrams(const QString &text, std::vector<quint64> &result)
+{
+    // NOTE: the result is sorted and doesn't contain any duplicates
+    result.reserve(result.size() + size_t(qMax(0, int(text.size()) - FILTER_INDEX_TRIGRAM_LENGTH + 1)));
+
+    for (int i = 0; i + FILTER_INDEX_TRIGRAM_LENGTH <= text.size(); ++i)
+        result.push_back(trigramKey(text.constData() + i));
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+bool internal::PropertyGridFilterIndex::textMatches(int id) const
+{
+    return m_texts[id].contains(m_query);
+}
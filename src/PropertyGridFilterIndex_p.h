@@ -0,0 +1,62 @@
+#ifndef PROPERTYGRIDFILTERINDEX_P_H
+#define PROPERTYGRIDFILTERINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // Case insensitive substring search over the texts of the properties (name, description and displayed value).
+    // Texts are identified by the dense ids handed out by addText(). A trigram index narrows down the candidates of a
+    // query, and a query that extends the previous one only re-checks the previous matches.
+    //
+    // NOTE: the posting lists are kept exact, a text that changes only touches the lists of the trigrams it gained or
+    //       lost. the ids within a list aren't ordered.
+    //
+    class PropertyGridFilterIndex
+    {
+    public:
+        int addText(const QString &text);
+        void setText(int id, const QString &text);
+        void clear();
+
+        int count() const;
+
+        const QString &query() const;
+        bool isActive() const;
+        // the ids whose match changed get appended to `changedIds`, when given
+        void setQuery(const QString &query, std::vector<int> *changedIds = nullptr);
+
+        bool matches(int id) const; // always true while there is no query
+
+    private:
+        static void appendTrigrams(const QString &text, std::vector<quint64> &result);
+        bool textMatches(int id) const;
+
+    private:
+        std::vector<QString> m_texts; // case folded
+        QHash<quint64, std::vector<int>> m_trigrams;
+
+        QString m_query; // case folded
+        std::vector<bool> m_matches;
+        std::vector<int> m_matchingIds;
+    };
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDFILTERINDEX_P_H
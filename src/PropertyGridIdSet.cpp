@@ -0,0 +1,35 @@
+#include "PropertyGridIdSet_p.h"
+
+using namespace PM;
+
+bool internal::PropertyGridIdSet::set(int id, bool value)
+{
+    if (contains(id) == value)
+        return false;
+
+    const size_t wordIndex = size_t(id) / 64;
+    const quint64 mask = quint64(1) << (id % 64);
+
+    // NOTE: removing never shrinks the words, only ids that get added may need more of them
+    if (wordIndex >= m_words.size())
+        m_words.resize(wordIndex + 1, 0);
+
+    if (value)
+    {
+        m_words[wordIndex] |= mask;
+        ++m_count;
+    }
+    else
+    {
+        m_words[wordIndex] &= ~mask;
+        --m_count;
+    }
+
+    return true;
+}
+
+void internal::PropertyGridIdSet::clear()
+{
+    m_words.clear();
+    m_count = 0;
+}
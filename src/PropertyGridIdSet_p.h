@@ -0,0 +1,69 @@
+#ifndef PROPERTYGRIDIDSET_P_H
+#define PROPERTYGRIDIDSET_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QtAlgorithms>
+
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // A set of the dense ids of PropertyGridTreeItem::propertyId, one bit per id. The number of ids in the set is kept
+    // up to date as they get added and removed, and visiting them skips 64 ids that aren't in the set at a time.
+    //
+    class PropertyGridIdSet
+    {
+    public:
+        bool contains(int id) const;
+        int count() const;
+
+        // returns true when the id got added or removed, false when it already was (or wasn't) in the set
+        bool set(int id, bool value);
+        void clear();
+
+        // visits the ids in ascending order
+        template <typename Function>
+        void forEach(const Function &function) const;
+
+    private:
+        std::vector<quint64> m_words;
+        int m_count = 0;
+    };
+} // namespace internal
+} // namespace PM
+
+inline bool PM::internal::PropertyGridIdSet::contains(int id) const
+{
+    const size_t wordIndex = size_t(id) / 64;
+
+    return wordIndex < m_words.size() && (m_words[wordIndex] & (quint64(1) << (id % 64))) != 0;
+}
+
+inline int PM::internal::PropertyGridIdSet::count() const
+{
+    return m_count;
+}
+
+template <typename Function>
+inline void PM::internal::PropertyGridIdSet::forEach(const Function &function) const
+{
+    for (size_t wordIndex = 0; wordIndex < m_words.size(); ++wordIndex)
+    {
+        for (quint64 word = m_words[wordIndex]; word != 0; word &= word - 1)
+            function(int(wordIndex * 64) + int(qCountTrailingZeroBits(word)));
+    }
+}
+
+#endif // PROPERTYGRIDIDSET_P_H
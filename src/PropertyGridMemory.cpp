@@ -0,0 +1,174 @@
+#include "PropertyGridMemory_p.h"
+
+#include "PropertyGridTreeItem_p.h"
+#include "QtCompat_p.h"
+
+#include <QPixmap>
+
+namespace
+{
+// the bookkeeping of a hash node besides its key and its value: the link to the next node and the hash
+const quint64 HASH_NODE_OVERHEAD = 2 * sizeof(void *);
+
+quint64 stringMemoryUsage(const QString &string)
+{
+    // NOTE: null and empty strings point to shared static data
+    if (string.capacity() == 0)
+        return 0;
+
+    return sizeof(QArrayData) + quint64(string.capacity() + 1) * sizeof(QChar);
+}
+
+quint64 stringListMemoryUsage(const QStringList &list)
+{
+    quint64 result = quint64(list.size()) * sizeof(QString);
+
+    for (const QString &string : list)
+        result += stringMemoryUsage(string);
+
+    return result;
+}
+
+quint64 pixmapMemoryUsage(const QPixmap &pixmap)
+{
+    if (pixmap.isNull())
+        return 0;
+
+    return quint64(pixmap.width()) * quint64(pixmap.height()) * quint64(pixmap.depth()) / 8;
+}
+
+quint64 variantMemoryUsage(const QVariant &value)
+{
+    // only strings and pixmaps are looked into, every other type counts for what the variant keeps inline
+    switch (PM::internal::getVariantTypeId(value))
+    {
+    case QMetaType::QString:
+        return stringMemoryUsage(value.toString());
+
+    case QMetaType::QStringList:
+        return stringListMemoryUsage(value.toStringList());
+
+    case QMetaType::QPixmap:
+        return pixmapMemoryUsage(value.value<QPixmap>());
+
+    default:
+        return 0;
+    }
+}
+
+bool isDisplayData(int columnIndex, Qt::ItemDataRole role)
+{
+    return columnIndex == 1 && (role == Qt::DisplayRole || role == Qt::DecorationRole);
+}
+
+bool isEvictable(const PM::internal::PropertyGridTreeItem *item)
+{
+    // categories don't have values, their rows are made of their names only
+    if (item->propertyId < 0 && !item->isElement())
+        return false;
+
+    const QHash<Qt::ItemDataRole, QVariant> &data = item->columnData(1);
+
+    return data.contains(Qt::DisplayRole) || data.contains(Qt::DecorationRole);
+}
+
+void measureItem(const PM::internal::PropertyGridTreeItem *item, PM::PropertyGridMemoryUsage &usage)
+{
+    using namespace PM::internal;
+
+    usage.treeNodesBytes += sizeof(PropertyGridTreeItem);
+    usage.treeNodesBytes += item->children.capacity() * sizeof(std::unique_ptr<PropertyGridTreeItem>);
+    usage.treeNodesBytes += item->visibleChildren.capacity() * sizeof(PropertyGridTreeItem *);
+    usage.treeNodesBytes += item->pendingChildren.capacity() * sizeof(PM::PropertyContext);
+    usage.treeNodesBytes += item->elementItems.bucket_count() * sizeof(void *);
+    usage.treeNodesBytes += item->elementItems.size() * (HASH_NODE_OVERHEAD + sizeof(std::pair<int, std::unique_ptr<PropertyGridTreeItem>>));
+    usage.treeNodesBytes += stringMemoryUsage(item->context.property().name());
+    usage.treeNodesBytes += stringListMemoryUsage(item->elementKeys);
+
+    usage.attributesBytes += attributesMemoryUsage(item->context.property());
+
+    for (const PM::PropertyContext &pendingChild : item->pendingChildren)
+    {
+        usage.treeNodesBytes += stringMemoryUsage(pendingChild.property().name());
+        usage.attributesBytes += attributesMemoryUsage(pendingChild.property());
+    }
+
+    for (int columnIndex = 0; columnIndex < 2; ++columnIndex)
+    {
+        const QHash<Qt::ItemDataRole, QVariant> &data = item->columnData(columnIndex);
+
+        usage.roleDataBytes += quint64(data.capacity()) * sizeof(void *);
+
+        for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+        {
+            usage.roleDataBytes += HASH_NODE_OVERHEAD + sizeof(Qt::ItemDataRole) + sizeof(QVariant);
+
+            if (!isDisplayData(columnIndex, it.key()))
+                usage.roleDataBytes += variantMemoryUsage(it.value());
+            else if (it.key() == Qt::DisplayRole)
+                usage.cachedStringsBytes += variantMemoryUsage(it.value());
+            else
+                usage.cachedPixmapsBytes += variantMemoryUsage(it.value());
+        }
+    }
+
+    if (item->isDisplayDataEvicted)
+        ++usage.evictedItemsCount;
+
+    for (const auto &child : item->children)
+        measureItem(child.get(), usage);
+
+    for (const auto &entry : item->elementItems)
+        measureItem(entry.second.get(), usage);
+}
+
+void collectEvictableItems(PM::internal::PropertyGridTreeItem *item, std::vector<PM::internal::PropertyGridTreeItem *> &result)
+{
+    if (isEvictable(item))
+        result.push_back(item);
+
+    for (const auto &child : item->children)
+        collectEvictableItems(child.get(), result);
+
+    for (const auto &entry : item->elementItems)
+        collectEvictableItems(entry.second.get(), result);
+}
+} // namespace
+
+using namespace PM;
+
+PropertyGridMemoryUsage internal::measureMemoryUsage(const PropertyGridTreeItem *rootItem)
+{
+    PropertyGridMemoryUsage result;
+
+    if (rootItem != nullptr)
+        measureItem(rootItem, result);
+
+    return result;
+}
+
+quint64 internal::displayDataMemoryUsage(const PropertyGridTreeItem *item)
+{
+    const QHash<Qt::ItemDataRole, QVariant> &data = item->columnData(1);
+
+    quint64 result = 0;
+
+    for (Qt::ItemDataRole role : {Qt::DisplayRole, Qt::DecorationRole})
+    {
+        const auto it = data.constFind(role);
+        if (it != data.constEnd())
+            result += HASH_NODE_OVERHEAD + sizeof(Qt::ItemDataRole) + sizeof(QVariant) + variantMemoryUsage(it.value());
+    }
+
+    return result;
+}
+
+std::vector<internal::PropertyGridTreeItem *> internal::evictableItems(PropertyGridTreeItem *rootItem)
+{
+    std::vector<PropertyGridTreeItem *> result;
+
+    if (rootItem != nullptr)
+        collectEvictableItems(rootItem, result);
+
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef PROPERTYGRIDMEMORYUSAGE_H
+#define PROPERTYGRIDMEMORYUSAGE_H
+
+#include <QtGlobal>
+
+namespace PM
+{
+//
+// Estimated heap footprint of a PropertyGrid in bytes, see PropertyGrid::memoryUsage().
+// The estimates are shallow: implicitly shared data (strings, pixmaps, ...) is counted once for every item holding it,
+// and values only count for what they keep inline plus the characters of strings.
+//
+struct PropertyGridMemoryUsage
+{
+    quint64 treeNodesBytes = 0;     // the items of the tree, their children and the descriptors of the unfetched ones
+    quint64 roleDataBytes = 0;      // the hashes holding the data of the columns, values included
+    quint64 attributesBytes = 0;    // the attributes of the properties, every item has its own copy
+    quint64 cachedStringsBytes = 0; // the displayed texts of the values
+    quint64 cachedPixmapsBytes = 0; // the decorations of the values
+    quint64 editorWidgetsBytes = 0; // the editors that are currently open
+
+    quint64 evictedItemsCount = 0; // items whose displayed text and decoration got evicted to stay within the budget
+
+    quint64 totalBytes() const
+    {
+        return treeNodesBytes + roleDataBytes + attributesBytes + cachedStringsBytes + cachedPixmapsBytes + editorWidgetsBytes;
+    }
+
+    // the part of the total that a memory budget can evict, see PropertyGrid::setMemoryBudget()
+    quint64 cachesBytes() const
+    {
+        return cachedStringsBytes + cachedPixmapsBytes;
+    }
+};
+} // namespace PM
+
+#endif // PROPERTYGRIDMEMORYUSAGE_H
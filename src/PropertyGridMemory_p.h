@@ -0,0 +1,35 @@
+#ifndef PROPERTYGRIDMEMORY_P_H
+#define PROPERTYGRIDMEMORY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include "PropertyGridMemoryUsage.h"
+
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    struct PropertyGridTreeItem;
+
+    // walks the whole tree, the editor widgets are up to the grid
+    PropertyGridMemoryUsage measureMemoryUsage(const PropertyGridTreeItem *rootItem);
+
+    // what evicting the displayed text and the decoration of the item would free
+    quint64 displayDataMemoryUsage(const PropertyGridTreeItem *item);
+
+    // the items below `rootItem` that have display data to evict, categories excluded
+    std::vector<PropertyGridTreeItem *> evictableItems(PropertyGridTreeItem *rootItem);
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDMEMORY_P_H
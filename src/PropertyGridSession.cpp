@@ -0,0 +1,443 @@
+#include "PropertyGridSession.h"
+
+#include "PropertyGrid_p.h"
+#include "PropertyGridTreeItem_p.h"
+#include "QtCompat_p.h"
+
+#include <QScrollBar>
+
+#include <memory>
+
+namespace
+{
+const quint32 SESSION_LOG_MAGIC = 0x504d4752; // "PMGR"
+const quint16 SESSION_LOG_VERSION = 1;
+
+// the oldest stream format that both Qt5 and Qt6 read and write
+const QDataStream::Version SESSION_LOG_STREAM_VERSION = QDataStream::Qt_5_9;
+
+// which of the basic attributes follow the type of a recorded property
+enum AttributeFlag : quint8
+{
+    DescriptionFlag = 0x01,
+    CategoryFlag = 0x02,
+    DefaultValueFlag = 0x04,
+    ReadOnlyFlag = 0x08,
+};
+} // namespace
+
+using namespace PM;
+
+PropertyGridRecorder::PropertyGridRecorder(PropertyGrid *grid, QIODevice *device, QObject *parent) :
+    QObject(parent),
+    m_grid(grid),
+    m_stream(device),
+    m_nextPropertyId(0)
+{
+    m_stream.setVersion(SESSION_LOG_STREAM_VERSION);
+    m_stream << SESSION_LOG_MAGIC << SESSION_LOG_VERSION;
+
+    if (grid == nullptr)
+        return;
+
+    PropertyGridPrivate *gridPrivate = PropertyGridPrivate::getImpl(*grid);
+    gridPrivate->m_recorder = this;
+
+    // the log starts with the state the grid is in right now
+    recordShowCategories(grid->showCategories());
+
+    for (const QString &propertyName : grid->propertyNames())
+    {
+        const PropertyContext context = grid->getPropertyContext(propertyName);
+        recordAddProperty(context.property(), context.value());
+    }
+
+    QTreeView *treeView = gridPrivate->ui->propertiesTreeView;
+
+    connect(treeView->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [this](const QModelIndex &current)
+            {
+                //
+                recordCurrentChanged(current);
+            });
+
+    connect(treeView->verticalScrollBar(), &QScrollBar::valueChanged, this,
+            [this](int value)
+            {
+                //
+                recordScroll(value);
+            });
+}
+
+PropertyGridRecorder::~PropertyGridRecorder()
+{
+    stop();
+}
+
+bool PropertyGridRecorder::isRecording() const
+{
+    return m_stream.device() != nullptr && m_stream.status() == QDataStream::Ok;
+}
+
+void PropertyGridRecorder::stop()
+{
+    if (m_grid != nullptr)
+    {
+        PropertyGridPrivate *gridPrivate = PropertyGridPrivate::getImpl(*m_grid);
+
+        if (gridPrivate->m_recorder == this)
+            gridPrivate->m_recorder = nullptr;
+    }
+
+    m_stream.setDevice(nullptr);
+}
+
+void PropertyGridRecorder::recordAddProperty(const Property &property, const QVariant &value)
+{
+    // the grid rejects these as well
+    if (!isRecording() || property.name().isEmpty() || m_propertyIds.contains(property.name()))
+        return;
+
+    quint8 attributes = 0;
+    if (property.hasAttribute<DescriptionAttribute>())
+        attributes |= DescriptionFlag;
+    if (property.hasAttribute<CategoryAttribute>())
+        attributes |= CategoryFlag;
+    if (property.hasAttribute<DefaultValueAttribute>())
+        attributes |= DefaultValueFlag;
+    if (property.hasAttribute<ReadOnlyAttribute>())
+        attributes |= ReadOnlyFlag;
+
+    // NOTE: types are recorded by name, the ids of the custom ones depend on the order they got registered in
+    m_stream << quint8(PropertyGridReplayer::AddProperty) << property.name() << internal::getMetaTypeName(property.type()).toLatin1() << attributes;
+
+    if (attributes & DescriptionFlag)
+        m_stream << property.getAttribute<DescriptionAttribute>().value;
+    if (attributes & CategoryFlag)
+        m_stream << property.getAttribute<CategoryAttribute>().value;
+    if (attributes & DefaultValueFlag)
+        writeValue(property.getAttribute<DefaultValueAttribute>().value);
+    if (attributes & ReadOnlyFlag)
+        m_stream << property.getAttribute<ReadOnlyAttribute>().value;
+
+    writeValue(value);
+
+    m_propertyIds.insert(property.name(), m_nextPropertyId++);
+}
+
+void PropertyGridRecorder::recordSetValue(const QString &propertyName, const QVariant &value)
+{
+    const qint64 id = propertyId(propertyName);
+
+    if (!isRecording() || id < 0)
+        return;
+
+    m_stream << quint8(PropertyGridReplayer::SetValue) << quint32(id);
+    writeValue(value);
+}
+
+void PropertyGridRecorder::recordEdit(const QString &propertyName, const QVariant &value)
+{
+    const qint64 id = propertyId(propertyName);
+
+    if (!isRecording() || id < 0)
+        return;
+
+    m_stream << quint8(PropertyGridReplayer::Edit) << quint32(id);
+    writeValue(value);
+}
+
+void PropertyGridRecorder::recordShowCategories(bool value)
+{
+    if (!isRecording())
+        return;
+
+    m_stream << quint8(PropertyGridReplayer::ShowCategories) << value;
+}
+
+void PropertyGridRecorder::recordClear()
+{
+    if (!isRecording())
+        return;
+
+    m_stream << quint8(PropertyGridReplayer::Clear);
+
+    m_propertyIds.clear();
+    m_nextPropertyId = 0;
+}
+
+void PropertyGridRecorder::recordCurrentChanged(const QModelIndex &current)
+{
+    if (!isRecording() || m_grid == nullptr)
+        return;
+
+    // elements are recorded as the property they belong to, categories as no property at all
+    const internal::PropertyGridTreeModel &model = PropertyGridPrivate::getImpl(*m_grid)->m_model;
+    const internal::PropertyGridTreeItem *item = current.isValid() ? model.getItem(current) : nullptr;
+
+    while (item != nullptr && item->isElement())
+        item = item->parent;
+
+    const bool isProperty = item != nullptr && model.getPropertyItem(item->context.property().name()) == item;
+
+    m_stream << quint8(PropertyGridReplayer::CurrentChanged) << qint32(isProperty ? propertyId(item->context.property().name()) : -1);
+}
+
+void PropertyGridRecorder::recordScroll(int value)
+{
+    if (!isRecording())
+        return;
+
+    m_stream << quint8(PropertyGridReplayer::Scroll) << qint32(value);
+}
+
+void PropertyGridRecorder::writeValue(const QVariant &value)
+{
+    // NOTE: a value without stream operators would leave a record behind that can't be read back
+    if (value.isValid() && !internal::hasDataStreamOperators(internal::getVariantTypeId(value)))
+        m_stream << QVariant();
+    else
+        m_stream << value;
+}
+
+qint64 PropertyGridRecorder::propertyId(const QString &propertyName) const
+{
+    const auto it = m_propertyIds.constFind(propertyName);
+
+    return it != m_propertyIds.constEnd() ? qint64(it.value()) : -1;
+}
+
+PropertyGridReplayer::PropertyGridReplayer(PropertyGrid *grid) : m_grid(grid), m_replayedCount(0)
+{
+}
+
+bool PropertyGridReplayer::open(QIODevice *device, QString *errorMessage)
+{
+    m_stream.setDevice(device);
+    m_stream.setVersion(SESSION_LOG_STREAM_VERSION);
+    m_propertyNames.clear();
+    m_replayedCount = 0;
+    m_errorString.clear();
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    m_stream >> magic >> version;
+
+    if (m_stream.status() != QDataStream::Ok || magic != SESSION_LOG_MAGIC)
+        fail("not a property grid session log");
+    else if (version > SESSION_LOG_VERSION)
+        fail(QString("unsupported session log version %1").arg(version));
+
+    if (errorMessage != nullptr)
+        *errorMessage = m_errorString;
+
+    return m_errorString.isEmpty();
+}
+
+bool PropertyGridReplayer::atEnd() const
+{
+    return m_stream.device() == nullptr || m_stream.atEnd();
+}
+
+bool PropertyGridReplayer::replayNext(RecordType *type)
+{
+    if (m_grid == nullptr || !m_errorString.isEmpty() || atEnd())
+        return false;
+
+    quint8 recordType = 0;
+    m_stream >> recordType;
+
+    switch (recordType)
+    {
+    case AddProperty:
+    {
+        QString name;
+        QByteArray typeName;
+        quint8 attributes = 0;
+        m_stream >> name >> typeName >> attributes;
+
+        Property property(name, internal::getMetaTypeId(typeName));
+
+        if (attributes & DescriptionFlag)
+        {
+            QString description;
+            m_stream >> description;
+            property.addAttribute(DescriptionAttribute(description));
+        }
+
+        if (attributes & CategoryFlag)
+        {
+            QString category;
+            m_stream >> category;
+            property.addAttribute(CategoryAttribute(category));
+        }
+
+        if (attributes & DefaultValueFlag)
+            property.addAttribute(DefaultValueAttribute(readValue()));
+
+        if (attributes & ReadOnlyFlag)
+        {
+            bool readOnly = true;
+            m_stream >> readOnly;
+            property.addAttribute(ReadOnlyAttribute(readOnly));
+        }
+
+        const QVariant value = readValue();
+
+        if (m_stream.status() != QDataStream::Ok)
+            return fail("truncated property record");
+
+        m_propertyNames.push_back(name);
+        m_grid->addProperty(property, value);
+        break;
+    }
+
+    case SetValue:
+    case Edit:
+    {
+        const QString propertyName = readPropertyName();
+        const QVariant value = readValue();
+
+        if (!m_errorString.isEmpty() || m_stream.status() != QDataStream::Ok)
+            return fail("truncated value record");
+
+        if (recordType == Edit)
+            replayEdit(propertyName, value);
+        else
+            m_grid->setPropertyValue(propertyName, value);
+
+        break;
+    }
+
+    case ShowCategories:
+    {
+        bool value = true;
+        m_stream >> value;
+        m_grid->setShowCategories(value);
+        break;
+    }
+
+    case Clear:
+        m_propertyNames.clear();
+        m_grid->clearProperties();
+        break;
+
+    case CurrentChanged:
+    {
+        qint32 id = -1;
+        m_stream >> id;
+
+        if (id >= int(m_propertyNames.size()))
+            return fail(QString("unknown property id %1").arg(id));
+
+        replayCurrentChanged(id >= 0 ? m_propertyNames[size_t(id)] : QString());
+        break;
+    }
+
+    case Scroll:
+    {
+        qint32 value = 0;
+        m_stream >> value;
+        PropertyGridPrivate::getImpl(*m_grid)->ui->propertiesTreeView->verticalScrollBar()->setValue(value);
+        break;
+    }
+
+    default:
+        return fail(QString("unknown record type %1").arg(recordType));
+    }
+
+    if (m_stream.status() != QDataStream::Ok)
+        return fail("truncated record");
+
+    if (type != nullptr)
+        *type = RecordType(recordType);
+
+    ++m_replayedCount;
+
+    return true;
+}
+
+bool PropertyGridReplayer::replayAll()
+{
+    while (replayNext())
+        ;
+
+    return m_errorString.isEmpty();
+}
+
+int PropertyGridReplayer::replayedCount() const
+{
+    return m_replayedCount;
+}
+
+QString PropertyGridReplayer::errorString() const
+{
+    return m_errorString;
+}
+
+QVariant PropertyGridReplayer::readValue()
+{
+    QVariant result;
+    m_stream >> result;
+
+    return result;
+}
+
+QString PropertyGridReplayer::readPropertyName()
+{
+    quint32 id = 0;
+    m_stream >> id;
+
+    if (id >= m_propertyNames.size())
+    {
+        fail(QString("unknown property id %1").arg(id));
+        return QString();
+    }
+
+    return m_propertyNames[id];
+}
+
+bool PropertyGridReplayer::fail(const QString &errorMessage)
+{
+    if (m_errorString.isEmpty())
+        m_errorString = QString("%1 (after %2 records)").arg(errorMessage).arg(m_replayedCount);
+
+    return false;
+}
+
+void PropertyGridReplayer::replayEdit(const QString &propertyName, const QVariant &value)
+{
+    PropertyGridPrivate *gridPrivate = PropertyGridPrivate::getImpl(*m_grid);
+
+    internal::PropertyGridTreeItem *item = gridPrivate->m_model.getPropertyItem(propertyName);
+    const QModelIndex index = item != nullptr ? internal::siblingAtColumn(gridPrivate->m_model.getItemIndex(item), 1) : QModelIndex();
+
+    // rows that aren't shown (filtered out, in a category that wasn't fetched yet, ...) can't be edited
+    if (!index.isValid())
+    {
+        m_grid->setPropertyValue(propertyName, value);
+        return;
+    }
+
+    QTreeView *treeView = gridPrivate->ui->propertiesTreeView;
+    const internal::PropertyGridItemDelegate &delegate = gridPrivate->tableViewItemDelegate;
+
+    std::unique_ptr<QWidget> editor(delegate.createEditor(treeView->viewport(), QStyleOptionViewItem(), index));
+    delegate.setEditorData(editor.get(), index);
+
+    internal::PropertyEditorWidget *editorWidget = qobject_cast<internal::PropertyEditorWidget *>(editor.get());
+    editorWidget->setUiValue(value);
+
+    // NOTE: not setModelData(), it pops a message box up for values that don't fit
+    gridPrivate->setPropertyValue(editorWidget->propertyContext(), editorWidget->uiValue());
+}
+
+void PropertyGridReplayer::replayCurrentChanged(const QString &propertyName)
+{
+    PropertyGridPrivate *gridPrivate = PropertyGridPrivate::getImpl(*m_grid);
+
+    internal::PropertyGridTreeItem *item = propertyName.isEmpty() ? nullptr : gridPrivate->m_model.getPropertyItem(propertyName);
+    const QModelIndex index = item != nullptr ? gridPrivate->m_model.getItemIndex(item) : QModelIndex();
+
+    gridPrivate->ui->propertiesTreeView->setCurrentIndex(index);
+}
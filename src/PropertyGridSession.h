@@ -0,0 +1,110 @@
+#ifndef PROPERTYGRIDSESSION_H
+#define PROPERTYGRIDSESSION_H
+
+#include "Property.h"
+
+#include <QDataStream>
+#include <QHash>
+#include <QModelIndex>
+#include <QObject>
+#include <QPointer>
+
+#include <vector>
+
+class QIODevice;
+
+namespace PM
+{
+class PropertyGrid;
+class PropertyGridPrivate;
+
+//
+// Records what happens to a PropertyGrid into a compact binary log: the properties that get added (with their basic
+// attributes), value changes, edits, selection changes, category toggles and scroll positions. The log can be replayed
+// against another grid with PropertyGridReplayer, e.g. to turn a customer's session into a performance regression test.
+//
+// NOTE: DependsOnAttribute and custom attributes aren't recorded, neither are values whose type has no QDataStream
+//       operators, those get replayed as invalid values.
+//
+class PropertyGridRecorder : public QObject
+{
+    Q_OBJECT
+
+    friend class PM::PropertyGridPrivate;
+
+public:
+    // the device must be open for writing and outlive the recorder
+    PropertyGridRecorder(PropertyGrid *grid, QIODevice *device, QObject *parent = nullptr);
+    ~PropertyGridRecorder();
+
+    bool isRecording() const; // false once stopped or after the device failed to write
+    void stop();
+
+private:
+    void recordAddProperty(const Property &property, const QVariant &value);
+    void recordSetValue(const QString &propertyName, const QVariant &value);
+    void recordEdit(const QString &propertyName, const QVariant &value);
+    void recordShowCategories(bool value);
+    void recordClear();
+    void recordCurrentChanged(const QModelIndex &current);
+    void recordScroll(int value);
+
+    void writeValue(const QVariant &value);
+    qint64 propertyId(const QString &propertyName) const; // -1 for the properties that weren't recorded
+
+private:
+    QPointer<PropertyGrid> m_grid;
+    QDataStream m_stream;
+    QHash<QString, quint32> m_propertyIds; // the log refers to the properties by the order they got added in
+    quint32 m_nextPropertyId;
+};
+
+//
+// Replays a log written by PropertyGridRecorder as fast as possible, one record at a time so that the caller can time
+// each of them or let the event loop run in between.
+//
+class PropertyGridReplayer
+{
+public:
+    enum RecordType
+    {
+        AddProperty = 1,
+        SetValue,
+        Edit, // goes through an editor widget, like the user did
+        ShowCategories,
+        Clear,
+        CurrentChanged,
+        Scroll,
+    };
+
+public:
+    explicit PropertyGridReplayer(PropertyGrid *grid);
+
+    // the device must be open for reading and outlive the replayer
+    bool open(QIODevice *device, QString *errorMessage = nullptr);
+
+    bool atEnd() const;
+    // replays the next record and tells which one it was, returns false at the end of the log or when it's corrupt
+    bool replayNext(RecordType *type = nullptr);
+    bool replayAll();
+
+    int replayedCount() const;
+    QString errorString() const;
+
+private:
+    QVariant readValue();
+    QString readPropertyName();
+    bool fail(const QString &errorMessage);
+    void replayEdit(const QString &propertyName, const QVariant &value);
+    void replayCurrentChanged(const QString &propertyName);
+
+private:
+    QPointer<PropertyGrid> m_grid;
+    QDataStream m_stream;
+    std::vector<QString> m_propertyNames; // by their id in the log
+    int m_replayedCount;
+    QString m_errorString;
+};
+} // namespace PM
+
+#endif // PROPERTYGRIDSESSION_H
@@ -0,0 +1,132 @@
+#include "PropertyGridStatistics_p.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <typeinfo>
+
+using namespace PM;
+
+namespace
+{
+void addTiming(std::atomic<quint64> &callsCount, std::atomic<quint64> &totalNanoseconds, qint64 nanoseconds)
+{
+    callsCount.fetch_add(1, std::memory_order_relaxed);
+    totalNanoseconds.fetch_add(quint64(nanoseconds), std::memory_order_relaxed);
+}
+
+PropertyGridStatistics::Timing loadTiming(const std::atomic<quint64> &callsCount, const std::atomic<quint64> &totalNanoseconds)
+{
+    PropertyGridStatistics::Timing result;
+    result.callsCount = callsCount.load(std::memory_order_relaxed);
+    result.totalNanoseconds = totalNanoseconds.load(std::memory_order_relaxed);
+
+    return result;
+}
+} // namespace
+
+internal::PropertyGridCounters::PropertyGridCounters()
+{
+    reset();
+}
+
+QString internal::PropertyGridCounters::toString(EditorCounters *counters, const PropertyEditor &editor, const PropertyContext &context)
+{
+    if (!isEnabled() || counters == nullptr)
+        return editor.toString(context);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString result = editor.toString(context);
+
+    TimingCounters &timing = counters->toString;
+    addTiming(timing.callsCount, timing.totalNanoseconds, timer.nsecsElapsed());
+
+    return result;
+}
+
+QVariant internal::PropertyGridCounters::fromString(EditorCounters *counters, const PropertyEditor &editor, const QString &text,
+                                                    const PropertyContext &context, QString *errorMessage)
+{
+    if (!isEnabled() || counters == nullptr)
+        return editor.fromString(text, context, errorMessage);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVariant result = editor.fromString(text, context, errorMessage);
+
+    TimingCounters &timing = counters->fromString;
+    addTiming(timing.callsCount, timing.totalNanoseconds, timer.nsecsElapsed());
+
+    return result;
+}
+
+PropertyGridStatistics internal::PropertyGridCounters::statistics() const
+{
+    PropertyGridStatistics result;
+    result.isEnabled = isEnabled();
+
+    for (int role = 0; role < dataRolesCount; ++role)
+    {
+        const quint64 count = m_dataCalls[role].load(std::memory_order_relaxed);
+
+        if (count != 0)
+            result.dataCallsPerRole[role < dataRolesCount - 1 ? role : int(Qt::UserRole)] = count;
+    }
+
+    {
+        QMutexLocker locker(&m_editorsMutex);
+
+        for (const auto &entry : m_editors)
+        {
+            PropertyGridStatistics::EditorStatistics &editorStatistics = result.editors[entry.first];
+            editorStatistics.toString = loadTiming(entry.second->toString.callsCount, entry.second->toString.totalNanoseconds);
+            editorStatistics.fromString = loadTiming(entry.second->fromString.callsCount, entry.second->fromString.totalNanoseconds);
+        }
+    }
+
+    result.editorLookupsCount = m_counters[EditorLookups].load(std::memory_order_relaxed);
+    result.decorationRendersCount = m_counters[DecorationRenders].load(std::memory_order_relaxed);
+    result.decorationCacheHitsCount = m_counters[DecorationCacheHits].load(std::memory_order_relaxed);
+    result.dataChangedEmissionsCount = m_counters[DataChangedEmissions].load(std::memory_order_relaxed);
+    result.modelResetsCount = m_counters[ModelResets].load(std::memory_order_relaxed);
+    result.editorWidgetCreationsCount = m_counters[EditorWidgetCreations].load(std::memory_order_relaxed);
+
+    return result;
+}
+
+void internal::PropertyGridCounters::reset()
+{
+    for (std::atomic<quint64> &counter : m_counters)
+        counter.store(0, std::memory_order_relaxed);
+
+    for (std::atomic<quint64> &counter : m_dataCalls)
+        counter.store(0, std::memory_order_relaxed);
+
+    // NOTE: the counters of the editors are zeroed rather than removed, a call that is still being timed may refer to them
+    QMutexLocker locker(&m_editorsMutex);
+
+    for (auto &entry : m_editors)
+    {
+        entry.second->toString.callsCount.store(0, std::memory_order_relaxed);
+        entry.second->toString.totalNanoseconds.store(0, std::memory_order_relaxed);
+        entry.second->fromString.callsCount.store(0, std::memory_order_relaxed);
+        entry.second->fromString.totalNanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+internal::PropertyGridCounters::EditorCounters *internal::PropertyGridCounters::editorCounters(const PropertyEditor &editor)
+{
+    if (!isEnabled())
+        return nullptr;
+
+    QMutexLocker locker(&m_editorsMutex);
+
+    std::unique_ptr<EditorCounters> &result = m_editors[TypeId(typeid(editor))];
+    if (result == nullptr)
+        result = std::make_unique<EditorCounters>();
+
+    return result.get();
+}
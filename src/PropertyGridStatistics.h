@@ -0,0 +1,52 @@
+#ifndef PROPERTYGRIDSTATISTICS_H
+#define PROPERTYGRIDSTATISTICS_H
+
+#include "Property.h"
+
+#include <map>
+#include <unordered_map>
+
+namespace PM
+{
+//
+// Cumulative counters and timings of a PropertyGrid, meant for diagnosing slow grids in production builds.
+// They are only collected when the library is built with PM_PROPERTY_GRID_ENABLE_STATISTICS, otherwise everything
+// stays zero and `isEnabled` is false.
+//
+struct PropertyGridStatistics
+{
+    struct Timing
+    {
+        quint64 callsCount = 0;
+        quint64 totalNanoseconds = 0;
+    };
+
+    struct EditorStatistics
+    {
+        Timing toString;
+        Timing fromString;
+    };
+
+    bool isEnabled = false;
+
+    std::map<int, quint64> dataCallsPerRole; // the roles from Qt::UserRole on are all counted as Qt::UserRole
+    std::unordered_map<TypeId, EditorStatistics> editors; // by the type of the editor, PropertyEditor itself being the default one
+
+    quint64 editorLookupsCount = 0;
+    quint64 decorationRendersCount = 0;
+    quint64 decorationCacheHitsCount = 0; // decorations that were served without rendering them again
+    quint64 dataChangedEmissionsCount = 0;
+    quint64 modelResetsCount = 0;
+    quint64 editorWidgetCreationsCount = 0;
+
+    template <typename T>
+    EditorStatistics editorStatistics() const
+    {
+        const auto it = editors.find(internal::getTypeId<T>());
+
+        return it != editors.end() ? it->second : EditorStatistics();
+    }
+};
+} // namespace PM
+
+#endif // PROPERTYGRIDSTATISTICS_H
@@ -0,0 +1,111 @@
+#ifndef PROPERTYGRIDSTATISTICS_P_H
+#define PROPERTYGRIDSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include "PropertyEditor.h"
+#include "PropertyGridStatistics.h"
+
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // The counters behind PropertyGrid::statistics(). Counting is a relaxed atomic increment, so that the counters
+    // can be left enabled, and compiles to nothing unless PM_PROPERTY_GRID_ENABLE_STATISTICS is defined.
+    //
+    class PropertyGridCounters
+    {
+    public:
+        enum Counter
+        {
+            EditorLookups,
+            DecorationRenders,
+            DecorationCacheHits,
+            DataChangedEmissions,
+            ModelResets,
+            EditorWidgetCreations,
+
+            CountersCount
+        };
+
+        struct TimingCounters
+        {
+            std::atomic<quint64> callsCount{0};
+            std::atomic<quint64> totalNanoseconds{0};
+        };
+
+        struct EditorCounters
+        {
+            TimingCounters toString;
+            TimingCounters fromString;
+        };
+
+        static constexpr bool isEnabled();
+
+        PropertyGridCounters();
+
+        void count(Counter counter);
+        void countDataCall(int role);
+
+        // the counters of the type of the editor, nullptr while the statistics are disabled. they live as long as this
+        // object does, so they are meant to be resolved once and kept around (this takes a lock)
+        EditorCounters *editorCounters(const PropertyEditor &editor);
+
+        // call the editor and time the call, `counters` can be nullptr
+        static QString toString(EditorCounters *counters, const PropertyEditor &editor, const PropertyContext &context);
+        static QVariant fromString(EditorCounters *counters, const PropertyEditor &editor, const QString &text, const PropertyContext &context,
+                                   QString *errorMessage = nullptr);
+
+        PropertyGridStatistics statistics() const;
+        void reset();
+
+    private:
+        // Qt's own roles are all below 32, the ones from Qt::UserRole on share the last slot
+        static const int dataRolesCount = 33;
+
+    private:
+        std::atomic<quint64> m_counters[CountersCount];
+        std::atomic<quint64> m_dataCalls[dataRolesCount];
+
+        mutable QMutex m_editorsMutex; // only guards the map, not the counters in it
+        std::unordered_map<TypeId, std::unique_ptr<EditorCounters>> m_editors;
+    };
+} // namespace internal
+} // namespace PM
+
+constexpr bool PM::internal::PropertyGridCounters::isEnabled()
+{
+#if defined(PM_PROPERTY_GRID_ENABLE_STATISTICS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void PM::internal::PropertyGridCounters::count(Counter counter)
+{
+    if (isEnabled())
+        m_counters[counter].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void PM::internal::PropertyGridCounters::countDataCall(int role)
+{
+    if (isEnabled())
+        m_dataCalls[role >= 0 && role < dataRolesCount - 1 ? role : dataRolesCount - 1].fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif // PROPERTYGRIDSTATISTICS_P_H
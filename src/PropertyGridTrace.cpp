@@ -0,0 +1,152 @@
+#include "PropertyGridTrace_p.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <vector>
+
+namespace
+{
+// ~64k spans, a few seconds of heavy editing
+const int TRACE_RING_BUFFER_CAPACITY = 1 << 16;
+
+struct TraceEvent
+{
+    const char *name;
+    QString detail;
+    qint64 start;
+    qint64 duration;
+    quint64 threadId;
+};
+
+struct TraceRingBuffer
+{
+    QMutex mutex;
+    std::vector<TraceEvent> events; // allocated the first time tracing gets enabled
+    size_t next = 0;
+    size_t count = 0;
+};
+
+TraceRingBuffer &ringBuffer()
+{
+    static TraceRingBuffer result;
+
+    return result;
+}
+} // namespace
+
+using namespace PM;
+
+std::atomic<bool> internal::PropertyGridTracer::s_isEnabled(false);
+
+void internal::PropertyGridTracer::setEnabled(bool value)
+{
+    if (!isAvailable())
+        return;
+
+    if (value)
+    {
+        TraceRingBuffer &buffer = ringBuffer();
+        QMutexLocker locker(&buffer.mutex);
+
+        if (buffer.events.empty())
+            buffer.events.resize(TRACE_RING_BUFFER_CAPACITY);
+
+        now(); // starts the clock
+    }
+
+    s_isEnabled.store(value, std::memory_order_relaxed);
+}
+
+qint64 internal::PropertyGridTracer::now()
+{
+    static const QElapsedTimer clock = []()
+    {
+        QElapsedTimer result;
+        result.start();
+
+        return result;
+    }();
+
+    return clock.nsecsElapsed();
+}
+
+void internal::PropertyGridTracer::record(const char *name, const QString &detail, qint64 start, qint64 duration)
+{
+    TraceRingBuffer &buffer = ringBuffer();
+    QMutexLocker locker(&buffer.mutex);
+
+    // NOTE: a span that started before tracing got enabled for the first time has nowhere to go
+    if (buffer.events.empty())
+        return;
+
+    TraceEvent &event = buffer.events[buffer.next];
+    event.name = name;
+    event.detail = detail;
+    event.start = start;
+    event.duration = duration;
+    event.threadId = quint64(quintptr(QThread::currentThreadId()));
+
+    buffer.next = (buffer.next + 1) % buffer.events.size();
+    buffer.count = qMin(buffer.count + 1, buffer.events.size());
+}
+
+void internal::PropertyGridTracer::clear()
+{
+    TraceRingBuffer &buffer = ringBuffer();
+    QMutexLocker locker(&buffer.mutex);
+
+    buffer.next = 0;
+    buffer.count = 0;
+}
+
+QByteArray internal::PropertyGridTracer::toChromeTraceJson()
+{
+    const double processId = double(QCoreApplication::applicationPid());
+
+    QJsonArray traceEvents;
+    QHash<quint64, int> threadIndexes; // thread ids are pointers on some platforms, the viewers get small numbers instead
+
+    {
+        TraceRingBuffer &buffer = ringBuffer();
+        QMutexLocker locker(&buffer.mutex);
+
+        // oldest first, the buffer might have wrapped around
+        const size_t first = (buffer.next + buffer.events.size() - buffer.count) % qMax<size_t>(buffer.events.size(), 1);
+
+        for (size_t i = 0; i < buffer.count; ++i)
+        {
+            const TraceEvent &event = buffer.events[(first + i) % buffer.events.size()];
+
+            if (!threadIndexes.contains(event.threadId))
+                threadIndexes.insert(event.threadId, int(threadIndexes.size()));
+
+            // complete events, the timestamps are in microseconds
+            QJsonObject traceEvent;
+            traceEvent.insert("name", QString::fromLatin1(event.name));
+            traceEvent.insert("cat", QStringLiteral("PropertyGrid"));
+            traceEvent.insert("ph", QStringLiteral("X"));
+            traceEvent.insert("ts", double(event.start) / 1000.0);
+            traceEvent.insert("dur", double(event.duration) / 1000.0);
+            traceEvent.insert("pid", processId);
+            traceEvent.insert("tid", threadIndexes.value(event.threadId));
+
+            if (!event.detail.isEmpty())
+                traceEvent.insert("args", QJsonObject{{"detail", event.detail}});
+
+            traceEvents.append(traceEvent);
+        }
+    }
+
+    QJsonObject result;
+    result.insert("traceEvents", traceEvents);
+    result.insert("displayTimeUnit", QStringLiteral("ms"));
+
+    return QJsonDocument(result).toJson(QJsonDocument::Compact);
+}
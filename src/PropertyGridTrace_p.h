@@ -0,0 +1,94 @@
+#ifndef PROPERTYGRIDTRACE_P_H
+#define PROPERTYGRIDTRACE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+
+namespace PM
+{
+namespace internal
+{
+    //
+    // Process wide ring buffer of the spans recorded by TraceSpan, the oldest spans get overwritten once it is full.
+    // Spans are only recorded when the library is built with PM_PROPERTY_GRID_ENABLE_TRACING and tracing got enabled
+    // at runtime, otherwise a span costs a relaxed atomic load.
+    //
+    class PropertyGridTracer
+    {
+    public:
+        static constexpr bool isAvailable();
+
+        static bool isEnabled();
+        static void setEnabled(bool value);
+
+        static qint64 now(); // nanoseconds since the first call
+        static void record(const char *name, const QString &detail, qint64 start, qint64 duration);
+        static void clear();
+
+        // the Chrome trace-event format, loads in chrome://tracing and ui.perfetto.dev
+        static QByteArray toChromeTraceJson();
+
+    private:
+        static std::atomic<bool> s_isEnabled;
+    };
+
+    // records the time between its construction and its destruction, `name` must outlive the trace (a literal)
+    class TraceSpan
+    {
+    public:
+        explicit TraceSpan(const char *name, const QString &detail = QString());
+        ~TraceSpan();
+
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+    private:
+        const char *m_name;
+        QString m_detail;
+        qint64 m_start; // negative when the span isn't being recorded
+    };
+} // namespace internal
+} // namespace PM
+
+constexpr bool PM::internal::PropertyGridTracer::isAvailable()
+{
+#if defined(PM_PROPERTY_GRID_ENABLE_TRACING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline bool PM::internal::PropertyGridTracer::isEnabled()
+{
+    return isAvailable() && s_isEnabled.load(std::memory_order_relaxed);
+}
+
+inline PM::internal::TraceSpan::TraceSpan(const char *name, const QString &detail) : m_name(name), m_start(-1)
+{
+    if (!PropertyGridTracer::isEnabled())
+        return;
+
+    m_detail = detail;
+    m_start = PropertyGridTracer::now();
+}
+
+inline PM::internal::TraceSpan::~TraceSpan()
+{
+    if (m_start >= 0)
+        PropertyGridTracer::record(m_name, m_detail, m_start, PropertyGridTracer::now() - m_start);
+}
+
+#endif // PROPERTYGRIDTRACE_P_H
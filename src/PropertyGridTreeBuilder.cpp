@@ -0,0 +1,215 @@
+#include "PropertyGridTreeBuilder_p.h"
+
+#include "PropertyContext_p.h"
+#include "PropertyGridTreeModel_p.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace
+{
+// how many properties get processed between two checks of the cancellation flag
+const int PROPERTY_GRID_BUILDER_CANCELLATION_CHECK_INTERVAL = 256;
+} // namespace
+
+using namespace PM;
+
+struct internal::PropertyGridTreeLoaderJob
+{
+    QMutex mutex;
+    PropertyGridTreeLoader *receiver; // guarded by `mutex`, gets reset when the loader is destroyed
+    quint64 generation;
+
+    std::atomic<bool> cancelled;
+
+    PropertyGridTreeBuilder builder;
+    PropertyList properties;
+    PropertyGridTreeSnapshot snapshot;
+
+public:
+    PropertyGridTreeLoaderJob(PropertyGridTreeLoader *receiver, quint64 generation, const PropertyGridTreeBuilder &builder,
+                              PropertyList &&properties) :
+        receiver(receiver),
+        generation(generation),
+        cancelled(false),
+        builder(builder),
+        properties(std::move(properties))
+    {
+    }
+};
+
+namespace
+{
+class PropertyGridTreeBuildTask : public QRunnable
+{
+public:
+    explicit PropertyGridTreeBuildTask(const std::shared_ptr<internal::PropertyGridTreeLoaderJob> &job) : m_job(job)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        if (m_job->cancelled)
+            return;
+
+        m_job->snapshot = m_job->builder.build(m_job->properties, &m_job->cancelled);
+        m_job->properties.clear(); // no need to keep a second copy of every property around
+
+        QMutexLocker locker(&m_job->mutex);
+
+        if (m_job->receiver == nullptr || m_job->cancelled)
+            return;
+
+        // NOTE: the receiver can't get destroyed while we are holding the mutex, see ~PropertyGridTreeLoader()
+        QMetaObject::invokeMethod(m_job->receiver, "onJobFinished", Qt::QueuedConnection, Q_ARG(quint64, m_job->generation));
+    }
+
+private:
+    std::shared_ptr<internal::PropertyGridTreeLoaderJob> m_job;
+};
+} // namespace
+
+internal::PropertyGridTreeBuilder::PropertyGridTreeBuilder(const PropertyEditorsMap_t &propertyEditors, PropertyEditor *defaultEditor,
+                                                           const Style &style) :
+    m_propertyEditors(propertyEditors),
+    m_defaultEditor(defaultEditor),
+    m_style(style)
+{
+}
+
+internal::PropertyGridTreeSnapshot internal::PropertyGridTreeBuilder::build(const PropertyList &properties, const std::atomic<bool> *cancelled) const
+{
+    PropertyGridTreeSnapshot result;
+    result.rootItem = std::make_unique<PropertyGridTreeItem>();
+    result.propertiesMap.reserve(int(properties.size()));
+
+    int processedCount = 0;
+    for (const auto &entry : properties)
+    {
+        if (cancelled != nullptr && ++processedCount % PROPERTY_GRID_BUILDER_CANCELLATION_CHECK_INTERVAL == 0 && *cancelled)
+            return PropertyGridTreeSnapshot();
+
+        const Property &property = entry.first;
+
+        // NEVER EVER allow any properties with empty names
+        if (property.name().isEmpty())
+            continue;
+
+        // property name is a unique identifier. duplicates are not allowed
+        if (result.propertiesMap.contains(property.name()))
+        {
+            qWarning() << "property" << property.name() << "alrready exists!";
+            continue;
+        }
+
+        // NOTE: the property grid gets assigned to the contexts when the tree is installed on the GUI thread
+        const PropertyContext context = PropertyContextPrivate::createContext(property, entry.second, nullptr, nullptr);
+
+        PropertyGridTreeItem *categoryItem = getCategoryItem(result, PropertyGridTreeModel::categoryName(property));
+        PropertyGridTreeItem *propertyItem = categoryItem->addChild(context);
+
+        const bool readOnly = internal::isReadOnly(property);
+
+        propertyItem->resetElements();
+
+        Qt::ItemFlags flags = propertyItem->flags(1);
+        flags.setFlag(Qt::ItemIsEditable, !readOnly && PropertyGridTreeItem::isEditableType(property.type()));
+        propertyItem->setFlags(1, flags);
+
+        if (readOnly)
+        {
+            propertyItem->setColumnData(0, Qt::ForegroundRole, m_style.readOnlyTextColor);
+            propertyItem->setColumnData(1, Qt::ForegroundRole, m_style.readOnlyTextColor);
+        }
+
+        const PropertyEditor *editor = findPropertyEditor(m_propertyEditors, context);
+        if (editor == nullptr)
+            editor = m_defaultEditor;
+
+        propertyItem->setValue(entry.second);
+        const QString summary = editor == m_defaultEditor ? propertyItem->elementsSummary() : QString();
+        propertyItem->setColumnData(1, Qt::DisplayRole, summary.isNull() ? editor->toString(context) : summary);
+
+        // NOTE: decorations are QPixmaps, those can only be generated on the GUI thread. the model has them generated
+        //       once they get shown, so that installing the tree doesn't go through all of the properties
+        propertyItem->isDecorationPending = true;
+
+        result.propertiesMap.insert(property.name(), propertyItem);
+    }
+
+    return result;
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeBuilder::getCategoryItem(PropertyGridTreeSnapshot &snapshot, const QString &category) const
+{
+    PropertyGridTreeItem *result = snapshot.categoriesMap.value(category);
+    if (result != nullptr)
+        return result;
+
+    // NOTE: same as PropertyGridTreeModel::getCategoryItem(), only the missing prefixes of a new path get resolved
+    const int separatorIndex = category.lastIndexOf(QLatin1Char(PropertyGridTreeModel::categoryPathSeparator));
+    PropertyGridTreeItem *parentItem = separatorIndex < 0 ? snapshot.rootItem.get() : getCategoryItem(snapshot, category.left(separatorIndex));
+
+    result = PropertyGridTreeModel::createCategoryItem(parentItem, category.mid(separatorIndex + 1), m_style.categoryFont,
+                                                       m_style.categoryBackgroundColor);
+    snapshot.categoriesMap.insert(category, result);
+
+    return result;
+}
+
+internal::PropertyGridTreeLoader::PropertyGridTreeLoader(QObject *parent) : QObject(parent), m_generation(0)
+{
+}
+
+internal::PropertyGridTreeLoader::~PropertyGridTreeLoader()
+{
+    cancel();
+}
+
+void internal::PropertyGridTreeLoader::start(const PropertyGridTreeBuilder &builder, PropertyList &&properties)
+{
+    cancel();
+
+    m_job = std::make_shared<PropertyGridTreeLoaderJob>(this, ++m_generation, builder, std::move(properties));
+
+    QThreadPool::globalInstance()->start(new PropertyGridTreeBuildTask(m_job));
+}
+
+void internal::PropertyGridTreeLoader::cancel()
+{
+    if (m_job == nullptr)
+        return;
+
+    m_job->cancelled = true;
+    {
+        QMutexLocker locker(&m_job->mutex);
+        m_job->receiver = nullptr;
+    }
+
+    m_job.reset();
+}
+
+bool internal::PropertyGridTreeLoader::isRunning() const
+{
+    return m_job != nullptr;
+}
+
+internal::PropertyGridTreeSnapshot internal::PropertyGridTreeLoader::takeSnapshot()
+{
+    return std::move(m_snapshot);
+}
+
+void internal::PropertyGridTreeLoader::onJobFinished(quint64 generation)
+{
+    // results of cancelled or superseded builds are silently dropped
+    if (m_job == nullptr || m_job->generation != generation)
+        return;
+
+    m_snapshot = std::move(m_job->snapshot);
+    m_job.reset();
+
+    emit finished();
+}
@@ -0,0 +1,105 @@
+#ifndef PROPERTYGRIDTREEBUILDER_P_H
+#define PROPERTYGRIDTREEBUILDER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include "PropertyGrid.h"
+#include "PropertyGridTreeItem_p.h"
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+
+#include <atomic>
+
+namespace PM
+{
+namespace internal
+{
+    // A complete tree that is not attached to any model yet
+    struct PropertyGridTreeSnapshot
+    {
+        std::unique_ptr<PropertyGridTreeItem> rootItem;
+
+        QHash<QString, PropertyGridTreeItem *> propertiesMap;
+        QHash<QString, PropertyGridTreeItem *> categoriesMap;
+    };
+
+    //
+    // Builds a detached PropertyGridTreeSnapshot out of a list of properties.
+    //
+    // NOTE: everything the builder needs from the GUI thread (fonts, colors, editors) is captured
+    //       when it gets constructed, which makes build() safe to call from a worker thread.
+    //       The only requirement is that PropertyEditor::toString() is reentrant.
+    //
+    class PropertyGridTreeBuilder
+    {
+    public:
+        struct Style
+        {
+            QFont categoryFont;
+            QColor categoryBackgroundColor;
+            QColor readOnlyTextColor;
+        };
+
+    public:
+        PropertyGridTreeBuilder(const PropertyEditorsMap_t &propertyEditors, PropertyEditor *defaultEditor, const Style &style);
+
+        PropertyGridTreeSnapshot build(const PropertyList &properties, const std::atomic<bool> *cancelled = nullptr) const;
+
+    private:
+        PropertyGridTreeItem *getCategoryItem(PropertyGridTreeSnapshot &snapshot, const QString &category) const;
+
+    private:
+        PropertyEditorsMap_t m_propertyEditors; // a copy, so that adding editors while building doesn't race with us
+        PropertyEditor *m_defaultEditor;
+        Style m_style;
+    };
+
+    struct PropertyGridTreeLoaderJob;
+
+    //
+    // Runs a PropertyGridTreeBuilder on the global thread pool and reports back on the thread this object lives in.
+    // Starting a new build or cancelling implicitly discards the result of any build that is still running.
+    //
+    class PropertyGridTreeLoader : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit PropertyGridTreeLoader(QObject *parent = nullptr);
+        ~PropertyGridTreeLoader();
+
+        void start(const PropertyGridTreeBuilder &builder, PropertyList &&properties);
+        void cancel();
+
+        bool isRunning() const;
+
+        PropertyGridTreeSnapshot takeSnapshot();
+
+    signals:
+        void finished();
+
+    private slots:
+        void onJobFinished(quint64 generation);
+
+    private:
+        std::shared_ptr<PropertyGridTreeLoaderJob> m_job;
+        quint64 m_generation;
+
+        PropertyGridTreeSnapshot m_snapshot;
+    };
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDTREEBUILDER_P_H
@@ -1,6 +1,26 @@
 #include "PropertyGridTreeItem_p.h"
 
+#include "PropertyBlob.h"
 #include "PropertyContext_p.h"
+#include "PropertyEditorFormatting_p.h"
+#include "PropertyGridCompositeTypes_p.h"
+#include "QtCompat_p.h"
+
+namespace
+{
+// blobs are split into at most this many pages, and pages into pages again until they fit in rows of hexRowSize bytes
+const qint64 PROPERTY_GRID_BLOB_PAGE_COUNT = 4096;
+
+qint64 blobPageSize(qint64 blobSize)
+{
+    qint64 result = PM::internal::hexRowSize;
+
+    while (blobSize > result * PROPERTY_GRID_BLOB_PAGE_COUNT)
+        result *= PROPERTY_GRID_BLOB_PAGE_COUNT;
+
+    return result;
+}
+} // namespace
 
 using namespace PM;
 
@@ -119,19 +139,6 @@ internal::PropertyGridTreeItem::Column::Column() : flags(Qt::ItemIsSelectable |
 {
 }
 
-int internal::PropertyGridTreeItem::childrenCount(bool showTransientItems) const
-{
-    if (showTransientItems)
-        return int(children.size());
-
-    int result = 0;
-
-    for (const auto &child : children)
-        result += child->isTransient ? child->childrenCount(showTransientItems) : 1;
-
-    return result;
-}
-
 bool internal::PropertyGridTreeItem::insertChildren(int position, int count, int columns)
 {
     if (position < 0 || position > children.size())
@@ -147,36 +154,6 @@ bool internal::PropertyGridTreeItem::insertChildren(int position, int count, int
     return true;
 }
 
-internal::PropertyGridTreeItem *internal::PropertyGridTreeItem::getChild(size_t index, bool showTransientItems) const
-{
-    // TODO: implement caching using an `isDirty` flag to make this function ~O(1)
-
-    size_t currentIndex = 0;
-    for (const auto &child : children)
-    {
-        if (showTransientItems || !child->isTransient)
-        {
-            if (currentIndex == index)
-                return child.get();
-
-            currentIndex++;
-        }
-        else if (!showTransientItems && child->isTransient)
-        {
-            // Handle the children of transient items directly here
-            for (const auto &grandChild : child->children)
-            {
-                if (currentIndex == index)
-                    return grandChild.get();
-
-                currentIndex++;
-            }
-        }
-    }
-
-    return nullptr; // Index out of range
-}
-
 internal::PropertyGridTreeItem *internal::PropertyGridTreeItem::addChild(const PropertyContext &context)
 {
     if (!insertChildren(static_cast<int>(children.size()), 1, 2))
@@ -203,11 +180,14 @@ QVariant internal::PropertyGridTreeItem::getColumnData(int columnIndex, Qt::Item
     if (columnIndex == 0 && role == Qt::DisplayRole)
         return context.property().name();
 
+    const QHash<Qt::ItemDataRole, QVariant> &data = columns[columnIndex].data;
+
     // in case the user didn't provide any data for the display role, we return the value of the edit role
-    if (role == Qt::DisplayRole && !columns[columnIndex].data.contains(Qt::DisplayRole)) // FIXME: stop using that
-        role = Qt::EditRole;
+    auto it = data.constFind(role);
+    if (it == data.constEnd() && role == Qt::DisplayRole) // FIXME: stop using that
+        it = data.constFind(Qt::EditRole);
 
-    return columns[columnIndex].data[role];
+    return it != data.constEnd() ? it.value() : QVariant();
 }
 
 void internal::PropertyGridTreeItem::setColumnData(int columnIndex, Qt::ItemDataRole role, const QVariant &newValue)
@@ -218,12 +198,31 @@ void internal::PropertyGridTreeItem::setColumnData(int columnIndex, Qt::ItemData
         return;
     }
 
+    if (columnIndex == 1 && role == Qt::DisplayRole)
+        isDisplayDataEvicted = false;
+
+    if (columnIndex == 1 && role == Qt::DecorationRole)
+        isDecorationPending = false;
+
     if (newValue.isValid())
         columns[columnIndex].data[role] = newValue;
     else // if the new value is invalid, remove it from the data to optimize space
         columns[columnIndex].data.remove(role);
 }
 
+const QHash<Qt::ItemDataRole, QVariant> &internal::PropertyGridTreeItem::columnData(int columnIndex) const
+{
+    return columns[columnIndex].data;
+}
+
+void internal::PropertyGridTreeItem::evictDisplayData()
+{
+    columns[1].data.remove(Qt::DisplayRole);
+    columns[1].data.remove(Qt::DecorationRole);
+
+    isDisplayDataEvicted = true;
+}
+
 void internal::PropertyGridTreeItem::setDataForAllColumns(Qt::ItemDataRole role, const QVariant &newValue)
 {
     setColumnData(0, role, newValue);
@@ -240,45 +239,341 @@ void internal::PropertyGridTreeItem::setFlags(int columnIndex, Qt::ItemFlags val
     columns[columnIndex].flags = value;
 }
 
-int internal::PropertyGridTreeItem::indexInParent(bool showTransientItems) const
+bool internal::PropertyGridTreeItem::isContainerType(int typeId)
+{
+    switch (typeId)
+    {
+    case qMetaTypeId<QStringList>():
+    case qMetaTypeId<QVariantList>():
+    case qMetaTypeId<QVariantMap>():
+    case qMetaTypeId<QVariantHash>():
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool internal::PropertyGridTreeItem::isEditableType(int typeId)
+{
+    return !isContainerType(typeId) && typeId != qMetaTypeId<PropertyBlob>();
+}
+
+bool internal::PropertyGridTreeItem::isElement() const
+{
+    return elementIndex >= 0;
+}
+
+QObject *internal::PropertyGridTreeItem::valueObject() const
+{
+    return valueObjectGuard.data();
+}
+
+void internal::PropertyGridTreeItem::trackValueObject()
+{
+    const QVariant value = context.value();
+
+    QObject *object = nullptr;
+    if (internal::isQObjectPointerType(internal::getVariantTypeId(value)))
+        object = value.value<QObject *>();
+
+    if (object == valueObjectAddress)
+        return;
+
+    valueObjectAddress = object;
+    valueObjectGuard = object;
+}
+
+bool internal::PropertyGridTreeItem::isValueObjectDestroyed() const
+{
+    return valueObjectAddress != nullptr && valueObjectGuard.isNull();
+}
+
+const internal::CompositeTypePlan *internal::PropertyGridTreeItem::valueCompositePlan() const
+{
+    const int typeId = context.property().type();
+
+    if (isContainerType(typeId))
+        return nullptr;
+
+    // NOTE: the plan of an object depends on its actual class, not on the declared type of the property
+    const QObject *object = valueObject();
+    if (object != nullptr)
+        return getObjectTypePlan(object->metaObject());
+
+    return getCompositeTypePlan(typeId);
+}
+
+int internal::PropertyGridTreeItem::valueElementsCount() const
+{
+    const QVariant value = context.value();
+    const int typeId = context.property().type();
+
+    // the pages of a blob are slices of it, a blob that fits in one row doesn't have any
+    if (typeId == qMetaTypeId<PropertyBlob>())
+    {
+        const qint64 size = value.value<PropertyBlob>().size();
+        const qint64 pageSize = blobPageSize(size);
+
+        return size > hexRowSize ? int((size + pageSize - 1) / pageSize) : 0;
+    }
+
+    switch (typeId)
+    {
+    case qMetaTypeId<QStringList>():
+        return int(value.toStringList().size());
+
+    case qMetaTypeId<QVariantList>():
+        return int(value.toList().size());
+
+    case qMetaTypeId<QVariantMap>():
+        return int(value.toMap().size());
+
+    case qMetaTypeId<QVariantHash>():
+        return int(value.toHash().size());
+
+    default:
+    {
+        const CompositeTypePlan *plan = valueCompositePlan();
+
+        return plan != nullptr ? int(plan->fields.size()) : 0;
+    }
+    }
+}
+
+QStringList internal::PropertyGridTreeItem::valueElementKeys() const
 {
-    if (parent == nullptr)
-        return -1;
+    switch (context.property().type())
+    {
+    case qMetaTypeId<QVariantMap>():
+        return context.value().toMap().keys();
+
+    case qMetaTypeId<QVariantHash>():
+        return context.value().toHash().keys();
+
+    default:
+        return QStringList();
+    }
+}
 
-    int currentIndex = 0;
-    for (const auto &child : parent->children)
+void internal::PropertyGridTreeItem::resetElements()
+{
+    trackValueObject();
+
+    elementItems.clear();
+    compositePlan = valueCompositePlan();
+    elementsCount = valueElementsCount();
+    elementKeys = valueElementKeys();
+}
+
+QString internal::PropertyGridTreeItem::elementName(int index) const
+{
+    if (compositePlan != nullptr)
+        return compositePlan->fields[index].name;
+
+    if (!elementKeys.isEmpty())
+        return elementKeys.at(index);
+
+    if (context.property().type() == qMetaTypeId<PropertyBlob>())
     {
-        if (showTransientItems || !child->isTransient)
-        {
-            if (child.get() == this)
-                return currentIndex;
-
-            currentIndex++;
-        }
-        else if (!showTransientItems && child->isTransient)
-        {
-            for (const auto &grandChild : child->children)
-            {
-                if (grandChild.get() == this)
-                    return currentIndex;
-
-                currentIndex++;
-            }
-        }
+        const PropertyBlob blob = context.value().value<PropertyBlob>();
+
+        return formatOffset(blob.offset() + index * blobPageSize(blob.size()));
     }
 
-    return -1;
+    return TextFormatter().appendChar('[').appendNumber(index).appendChar(']').toString();
 }
 
-internal::PropertyGridTreeItem::PropertyGridTreeItem() : context(PM::PropertyContextPrivate::invalidContext()), parent(nullptr), isTransient(false)
+QVariant internal::PropertyGridTreeItem::elementValue(int index) const
+{
+    // NOTE: all of the containers are implicitly shared, converting them out of the QVariant doesn't copy the elements
+    const QVariant value = context.value();
+    const int typeId = context.property().type();
+
+    if (typeId == qMetaTypeId<PropertyBlob>())
+    {
+        const PropertyBlob blob = value.value<PropertyBlob>();
+        const qint64 pageSize = blobPageSize(blob.size());
+
+        return QVariant::fromValue(blob.slice(index * pageSize, pageSize));
+    }
+
+    switch (typeId)
+    {
+    case qMetaTypeId<QStringList>():
+        return value.toStringList().at(index);
+
+    case qMetaTypeId<QVariantList>():
+        return value.toList().at(index);
+
+    case qMetaTypeId<QVariantMap>():
+        return value.toMap().value(elementKeys.at(index));
+
+    case qMetaTypeId<QVariantHash>():
+        return value.toHash().value(elementKeys.at(index));
+
+    default:
+        // NOTE: the fields of objects are read from the object itself
+        if (compositePlan == nullptr || isValueObjectDestroyed())
+            return QVariant();
+
+        return compositePlan->fields[index].read(value);
+    }
+}
+
+QVariant internal::PropertyGridTreeItem::valueWithElement(int index, const QVariant &elementValue) const
+{
+    const QVariant value = context.value();
+
+    switch (context.property().type())
+    {
+    case qMetaTypeId<QStringList>():
+    {
+        QStringList result = value.toStringList();
+        result[index] = elementValue.toString();
+
+        return result;
+    }
+
+    case qMetaTypeId<QVariantList>():
+    {
+        QVariantList result = value.toList();
+        result[index] = elementValue;
+
+        return result;
+    }
+
+    case qMetaTypeId<QVariantMap>():
+    {
+        QVariantMap result = value.toMap();
+        result.insert(elementKeys.at(index), elementValue);
+
+        return result;
+    }
+
+    case qMetaTypeId<QVariantHash>():
+    {
+        QVariantHash result = value.toHash();
+        result.insert(elementKeys.at(index), elementValue);
+
+        return result;
+    }
+
+    default:
+    {
+        QVariant result = value;
+
+        if (compositePlan != nullptr && compositePlan->fields[index].write && !isValueObjectDestroyed())
+            compositePlan->fields[index].write(result, elementValue);
+
+        return result;
+    }
+    }
+}
+
+QString internal::PropertyGridTreeItem::elementsSummary() const
+{
+    if (isContainerType(context.property().type()))
+        return TextFormatter().appendChar('[').appendNumber(elementsCount).appendLiteral(" items]").toString();
+
+    const QObject *object = valueObject();
+    if (object != nullptr)
+        return QString("%1 (%2)").arg(object->metaObject()->className(), object->objectName());
+
+    return QString();
+}
+
+bool internal::PropertyGridTreeItem::isObjectReferencedByAncestors(const QObject *object) const
+{
+    for (const PropertyGridTreeItem *ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent)
+    {
+        if (ancestor->valueObject() == object)
+            return true;
+    }
+
+    return false;
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeItem::createElement(int index)
+{
+    const QVariant value = elementValue(index);
+
+    int typeId = internal::getVariantTypeId(value);
+    if (compositePlan != nullptr)
+        typeId = compositePlan->fields[index].typeId;
+    else if (context.property().type() == qMetaTypeId<QStringList>())
+        typeId = qMetaTypeId<QString>();
+
+    const bool readOnly = internal::isReadOnly(context.property()) || (compositePlan != nullptr && !compositePlan->fields[index].write);
+
+    Property property(elementName(index), typeId);
+    if (readOnly)
+        property.addAttribute(ReadOnlyAttribute());
+
+    auto element = std::make_unique<PropertyGridTreeItem>();
+    element->context = PropertyContextPrivate::createContext(property, value, nullptr, context.propertyGrid());
+    element->parent = this;
+    element->elementIndex = index;
+    element->resetElements();
+
+    // cycles in object graphs are shown as leaves, otherwise they could be expanded forever
+    const QObject *object = element->valueObject();
+    if (object != nullptr && element->isObjectReferencedByAncestors(object))
+    {
+        element->compositePlan = nullptr;
+        element->elementsCount = 0;
+    }
+
+    // containers are edited through their elements
+    Qt::ItemFlags flags = element->flags(1);
+    flags.setFlag(Qt::ItemIsEditable, !readOnly && isEditableType(typeId));
+    element->setFlags(1, flags);
+
+    PropertyGridTreeItem *result = element.get();
+    elementItems.emplace(index, std::move(element));
+
+    return result;
+}
+
+internal::PropertyGridTreeItem::PropertyGridTreeItem() :
+    context(PM::PropertyContextPrivate::invalidContext()),
+    parent(nullptr),
+    isTransient(false),
+    childrenFetched(true),
+    elementIndex(-1),
+    elementsCount(0),
+    compositePlan(nullptr),
+    valueObjectAddress(nullptr),
+    visibleRow(-1),
+    propertyId(-1),
+    isHidden(false),
+    isDisplayDataEvicted(false),
+    isDecorationPending(false),
+    lastAccess(0)
 {
 }
 
 internal::PropertyGridTreeItem::PropertyGridTreeItem(const internal::PropertyGridTreeItem &other) :
     context(other.context),
     parent(other.parent),
-    isTransient(other.isTransient)
+    isTransient(other.isTransient),
+    pendingChildren(other.pendingChildren),
+    childrenFetched(other.childrenFetched),
+    elementIndex(other.elementIndex),
+    elementsCount(other.elementsCount),
+    elementKeys(other.elementKeys),
+    compositePlan(other.compositePlan),
+    valueObjectGuard(other.valueObjectGuard),
+    valueObjectAddress(other.valueObjectAddress),
+    visibleRow(-1),
+    propertyId(-1),
+    isHidden(false),
+    isDisplayDataEvicted(other.isDisplayDataEvicted),
+    isDecorationPending(other.isDecorationPending),
+    lastAccess(0)
 {
+    // NOTE: element items are only a cache, the copy creates them again when they get accessed
+
     columns[0] = other.columns[0];
     columns[1] = other.columns[1];
 
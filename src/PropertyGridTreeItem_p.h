@@ -14,9 +14,13 @@
 #include "PropertyContext.h"
 
 #include <QList>
+#include <QPointer>
+#include <QStringList>
 #include <QVariant>
 #include <QVector>
 
+#include <unordered_map>
+
 class TreeItem
 {
 public:
@@ -46,6 +50,8 @@ namespace PM
 {
 namespace internal
 {
+    struct CompositeTypePlan;
+
     struct PropertyGridTreeItem
     {
         struct Column
@@ -64,13 +70,42 @@ namespace internal
 
         bool isTransient;
 
+        // children that are only known by their descriptors so far, their items get created when they are first needed
+        std::vector<PM::PropertyContext> pendingChildren;
+        bool childrenFetched;
+
+        // elements of container values (lists and maps), fields of composite values (QSize, QRect, Q_GADGETs, QObjects, ...)
+        // and pages of blobs are virtual child rows, their items only get created on first access
+        int elementIndex; // index of this item in the elements of its parent, -1 for regular items
+        int elementsCount;
+        QStringList elementKeys;                 // keys of map values, in the order of the element rows
+        const CompositeTypePlan *compositePlan; // only set for composite values
+        std::unordered_map<int, std::unique_ptr<PropertyGridTreeItem>> elementItems;
+
+        // the object referenced by the value (if it holds a pointer to one), see trackValueObject(). the address is only
+        // ever compared, the object may be gone already
+        QPointer<QObject> valueObjectGuard;
+        const QObject *valueObjectAddress;
+
+        // rows of this item as the model exposes them (filtered, sorted, and without the categories in flat mode).
+        // the properties of a category come before its subcategories, see PropertyGridTreeModel
+        std::vector<PropertyGridTreeItem *> visibleChildren;
+        int visibleRow; // row of this item in the visible children of its parent, -1 when it isn't shown
+
+        int propertyId; // dense id of properties, handed out when they get added (before their items get created), -1 for categories and elements
+        bool isHidden;  // hidden regardless of the filter, see DependsOnAttribute::isVisible
+
+        // the displayed text and the decoration of the value are caches, they get evicted when the grid goes over its
+        // memory budget and the model has them generated again the next time they are asked for. element items start
+        // out evicted
+        bool isDisplayDataEvicted;
+        bool isDecorationPending; // the decoration wasn't generated yet, see PropertyGridTreeBuilder
+        quint64 lastAccess; // when the model last handed out data of this item, see PropertyGridTreeModel::data()
+
         // TODO: maybe add a flag to store if the node is expanded or collapsed?!!
         // TODO: maybe add an index container for the children to access them by name?!!
 
     public:
-        int childrenCount(bool showTransientItems = true) const;
-        PropertyGridTreeItem *getChild(size_t index, bool showTransientItems = true) const;
-
         bool insertChildren(int position, int count, int columns);
         PropertyGridTreeItem *addChild(const PM::PropertyContext &context);
 
@@ -79,13 +114,36 @@ namespace internal
 
         QVariant getColumnData(int columnIndex, Qt::ItemDataRole role) const;
         void setColumnData(int columnIndex, Qt::ItemDataRole role, const QVariant &newValue);
+        const QHash<Qt::ItemDataRole, QVariant> &columnData(int columnIndex) const;
+
+        void evictDisplayData();
 
         [[deprecated]] void setDataForAllColumns(Qt::ItemDataRole role, const QVariant &newValue);
 
         Qt::ItemFlags flags(int columnIndex) const;
         void setFlags(int columnIndex, Qt::ItemFlags value);
 
-        int indexInParent(bool showTransientItems = true) const;
+        static bool isContainerType(int typeId);
+        static bool isEditableType(int typeId); // containers are edited through their elements, blobs aren't editable at all
+
+        bool isElement() const;
+        QObject *valueObject() const; // the object referenced by the value, nullptr once it got deleted
+        // picks up the object referenced by a value that just got set. values that still point to the same address keep
+        // their guard, so a deleted object never gets dereferenced again
+        void trackValueObject();
+        bool isValueObjectDestroyed() const;
+        const CompositeTypePlan *valueCompositePlan() const;
+        int valueElementsCount() const;
+        QStringList valueElementKeys() const;
+        void resetElements();
+
+        QString elementName(int index) const;
+        QVariant elementValue(int index) const;
+        QVariant valueWithElement(int index, const QVariant &elementValue) const; // a copy of the value with one element replaced
+        QString elementsSummary() const; // a null string when the value doesn't have a summary
+
+        bool isObjectReferencedByAncestors(const QObject *object) const;
+        PropertyGridTreeItem *createElement(int index);
 
     public:
         PropertyGridTreeItem();
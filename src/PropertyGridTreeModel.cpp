@@ -1,12 +1,23 @@
 #include "PropertyGridTreeModel_p.h"
 
 #include "PropertyContext_p.h"
+#include "PropertyGridCompositeTypes_p.h"
+#include "PropertyGridMemory_p.h"
+#include "PropertyGridTreeBuilder_p.h"
+#include "PropertyGridTrace_p.h"
 #include "PropertyGridTreeItem_p.h"
 #include "QtCompat_p.h"
 
 #include <QApplication>
 #include <QDebug>
+#include <QSet>
 #include <QString>
+#include <QTimer>
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace
 {
@@ -18,8 +29,21 @@ using namespace PM;
 internal::PropertyGridTreeModel::PropertyGridTreeModel(QObject *parent) :
     QAbstractItemModel(parent),
     m_showCategories(true),
-    m_rootItem(new PropertyGridTreeItem())
+    m_categoriesExpandedByDefault(true),
+    m_sortMode(PropertyGrid::SortMode::InsertionOrder),
+    m_rootItem(new PropertyGridTreeItem()),
+    m_accessClock(0),
+    m_isDestroyedObjectsCleanupScheduled(false)
 {
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collator.setNumericMode(true);
+
+    // NOTE: every emission goes through the signals, counting them here catches all of them
+    if (PropertyGridCounters::isEnabled())
+    {
+        connect(this, &QAbstractItemModel::dataChanged, this, [this]() { m_counters.count(PropertyGridCounters::DataChangedEmissions); });
+        connect(this, &QAbstractItemModel::modelReset, this, [this]() { m_counters.count(PropertyGridCounters::ModelResets); });
+    }
 }
 
 internal::PropertyGridTreeModel::~PropertyGridTreeModel()
@@ -40,7 +64,10 @@ int internal::PropertyGridTreeModel::rowCount(const QModelIndex &parent) const
 
     const PropertyGridTreeItem *parentItem = getItem(parent);
 
-    return parentItem ? parentItem->childrenCount(m_showCategories) : 0;
+    if (parentItem->elementsCount > 0)
+        return parentItem->elementsCount;
+
+    return int(parentItem->visibleChildren.size());
 }
 
 QVariant internal::PropertyGridTreeModel::data(const QModelIndex &index, int role) const
@@ -48,10 +75,27 @@ QVariant internal::PropertyGridTreeModel::data(const QModelIndex &index, int rol
     // CRITICAL: initialy the view asks the model for some basic data like the text alignment and the font.
     // if the answer was something else that isn't the expected data type OR an empty QVariant, the item will not be displayed
 
+    m_counters.countDataCall(role);
+
     if (!index.isValid())
         return QVariant();
 
     PropertyGridTreeItem *item = getItem(index);
+    item->lastAccess = ++m_accessClock;
+
+    // the decorations that have to be rendered first are counted by the grid, see PropertyGridCounters::DecorationRenders
+    if (index.column() == 1 && role == Qt::DecorationRole && !item->isDisplayDataEvicted && !item->isDecorationPending)
+        m_counters.count(PropertyGridCounters::DecorationCacheHits);
+
+    if (index.column() == 1 && (role == Qt::DisplayRole || role == Qt::DecorationRole))
+        ensureDisplayData(item);
+
+    if (index.column() == 1 && role == Qt::DecorationRole)
+        ensureDecoration(item);
+
+    // NOTE: the values are never compared to their defaults here, see updateModifiedState()
+    if (index.column() == 1 && role == Qt::FontRole && item->propertyId >= 0 && m_modifiedProperties.contains(item->propertyId))
+        return modifiedValueFont();
 
     return item->getColumnData(index.column(), Qt::ItemDataRole(role));
 }
@@ -90,6 +134,33 @@ Qt::ItemFlags internal::PropertyGridTreeModel::flags(const QModelIndex &index) c
     return item->flags(index.column());
 }
 
+bool internal::PropertyGridTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (canFetchMore(parent))
+        return true;
+
+    return QAbstractItemModel::hasChildren(parent);
+}
+
+bool internal::PropertyGridTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    // NOTE: pending children only exist in categories, and all of them get fetched before switching to flat mode
+    if (!parent.isValid() || parent.column() > 0)
+        return false;
+
+    const PropertyGridTreeItem *item = getItem(parent);
+
+    return !item->childrenFetched;
+}
+
+void internal::PropertyGridTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    fetchCategory(getItem(parent));
+}
+
 internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getItem(const QModelIndex &index) const
 {
     // NOTE: this function never returns nullptr
@@ -114,11 +185,28 @@ void internal::PropertyGridTreeModel::setShowCategories(bool newShowCategories)
     if (m_showCategories == newShowCategories)
         return;
 
+    // transient categories can't be expanded in flat mode, so their properties need to exist by then
+    if (!newShowCategories)
+    {
+        for (PropertyGridTreeItem *categoryItem : m_categoriesMap)
+            fetchCategory(categoryItem);
+    }
+
     m_showCategories = newShowCategories;
 
     update();
 }
 
+bool internal::PropertyGridTreeModel::categoriesExpandedByDefault() const
+{
+    return m_categoriesExpandedByDefault;
+}
+
+void internal::PropertyGridTreeModel::setCategoriesExpandedByDefault(bool value)
+{
+    m_categoriesExpandedByDefault = value;
+}
+
 internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::rootItem() const
 {
     return m_rootItem;
@@ -128,7 +216,7 @@ bool internal::PropertyGridTreeModel::isCategory(const QModelIndex &index) const
 {
     PropertyGridTreeItem *item = getItem(index);
 
-    return item->parent == m_rootItem;
+    return item->isTransient;
 }
 
 internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getPropertyItem(const QString &propertyName) const
@@ -136,6 +224,25 @@ internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getPropertyItem
     return m_propertiesMap.value(propertyName);
 }
 
+PropertyContext *internal::PropertyGridTreeModel::getPendingPropertyContext(const QString &propertyName) const
+{
+    auto it = m_pendingPropertiesMap.find(propertyName);
+    if (it == m_pendingPropertiesMap.end())
+        return nullptr;
+
+    return &it->categoryItem->pendingChildren[it->index];
+}
+
+const QHash<QString, internal::PropertyGridTreeItem *> &internal::PropertyGridTreeModel::propertyItems() const
+{
+    return m_propertiesMap;
+}
+
+const QHash<QString, internal::PropertyGridTreeItem *> &internal::PropertyGridTreeModel::categoryItems() const
+{
+    return m_categoriesMap;
+}
+
 QModelIndex internal::PropertyGridTreeModel::getCategory(const QString &category) const
 {
     PropertyGridTreeItem *item = const_cast<PropertyGridTreeModel *>(this)->getCategoryItem(category);
@@ -143,137 +250,1672 @@ QModelIndex internal::PropertyGridTreeModel::getCategory(const QString &category
     return getItemIndex(item);
 }
 
+void internal::PropertyGridTreeModel::setItemInitializer(const ItemInitializer &initializer)
+{
+    m_itemInitializer = initializer;
+}
+
+void internal::PropertyGridTreeModel::setElementItemInitializer(const ItemInitializer &initializer)
+{
+    m_elementItemInitializer = initializer;
+}
+
+void internal::PropertyGridTreeModel::setItemDataLoader(const ItemInitializer &loader)
+{
+    m_itemDataLoader = loader;
+}
+
+void internal::PropertyGridTreeModel::setItemDecorationLoader(const ItemInitializer &loader)
+{
+    m_itemDecorationLoader = loader;
+}
+
 QModelIndex internal::PropertyGridTreeModel::addProperty(const PropertyContext &context)
 {
-    QString category = DEFAULT_CATEGORY_NAME;
-    if (context.property().hasAttribute<CategoryAttribute>())
-        category = context.property().getAttribute<CategoryAttribute>().value;
+    addProperties({context});
+
+    PropertyGridTreeItem *propertyItem = getPropertyItem(context.property().name());
+    if (propertyItem == nullptr)
+        return QModelIndex();
+
+    return getItemIndex(propertyItem);
+}
+
+void internal::PropertyGridTreeModel::addProperties(const std::vector<PropertyContext> &contexts)
+{
+    // group the new properties by category (keeping their order), each group is then inserted as one range of rows
+    std::vector<std::pair<QString, std::vector<const PropertyContext *>>> groups;
+    QHash<QString, size_t> groupsIndices;
+    QSet<QString> addedNames;
+
+    for (const PropertyContext &context : contexts)
+    {
+        const QString name = context.property().name();
 
-    internal::PropertyGridTreeItem *categoryItem = getCategoryItem(category);
-    internal::PropertyGridTreeItem *PropertyItem = categoryItem->addChild(context);
+        // NEVER EVER allow any properties with empty names
+        if (name.isEmpty())
+            continue;
 
-    m_propertiesMap[context.property().name()] = PropertyItem;
+        // property name is a unique identifier. duplicates are not allowed
+        if (m_propertiesMap.contains(name) || m_pendingPropertiesMap.contains(name) || addedNames.contains(name))
+        {
+            qWarning() << "property" << name << "alrready exists!";
+            continue;
+        }
 
-    bool readOnly = context.property().hasAttribute<ReadOnlyAttribute>() && context.property().getAttribute<ReadOnlyAttribute>().value == true;
+        addedNames.insert(name);
 
-    Qt::ItemFlags flags = PropertyItem->flags(1);
-    flags.setFlag(Qt::ItemIsEditable, !readOnly);
-    PropertyItem->setFlags(1, flags);
+        const QString category = categoryName(context.property());
 
-    return getItemIndex(PropertyItem);
+        auto groupIt = groupsIndices.find(category);
+        if (groupIt == groupsIndices.end())
+        {
+            groupIt = groupsIndices.insert(category, groups.size());
+            groups.emplace_back(category, std::vector<const PropertyContext *>());
+        }
+
+        groups[groupIt.value()].second.push_back(&context);
+    }
+
+    for (const auto &group : groups)
+        insertPropertiesIntoCategory(group.first, group.second);
 }
 
-QModelIndex internal::PropertyGridTreeModel::getItemIndex(PropertyGridTreeItem *item) const
+void internal::PropertyGridTreeModel::insertPropertiesIntoCategory(const QString &category, const std::vector<const PropertyContext *> &contexts)
 {
-    return createIndex(item->indexInParent(m_showCategories), 0, item);
+    PropertyGridTreeItem *categoryItem = m_categoriesMap.value(category);
+
+    // NOTE: new items are invisible to the view until they get added to the visible children of their parent
+    if (categoryItem == nullptr)
+        categoryItem = getCategoryItem(category);
+
+    // categories that weren't fetched yet only need to remember the descriptors
+    if (!categoryItem->childrenFetched)
+    {
+        // NOTE: the values of pending properties aren't displayed yet, only their names and descriptions can be searched until
+        //       the items get created
+        for (const PropertyContext *context : contexts)
+        {
+            const int propertyId = registerProperty(*context, searchableText(context->property(), QString()));
+
+            m_pendingPropertiesMap.insert(context->property().name(), {categoryItem, categoryItem->pendingChildren.size(), propertyId});
+            categoryItem->pendingChildren.push_back(*context);
+        }
+
+        // the category is shown once any of its properties matches the filter, expanding it is what creates them
+        if (categoryItem->visibleRow < 0 && isCategoryAccepted(categoryItem))
+        {
+            showCategoryRow(categoryItem);
+            sortCategoryRow(categoryItem);
+        }
+
+        return;
+    }
+
+    std::vector<PropertyGridTreeItem *> items;
+    items.reserve(contexts.size());
+
+    for (const PropertyContext *context : contexts)
+        items.push_back(createPropertyItem(categoryItem, *context));
+
+    insertVisibleRows(categoryItem, items);
+    sortInsertedRows(categoryItem, items);
 }
 
-void internal::PropertyGridTreeModel::clearModel()
+internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::createPropertyItem(PropertyGridTreeItem *categoryItem,
+                                                                                    const PropertyContext &context, int propertyId)
 {
-    beginResetModel();
+    PropertyGridTreeItem *result = categoryItem->addChild(context);
+
+    m_propertiesMap.insert(context.property().name(), result);
+
+    result->resetElements();
+    watchValueObject(result);
+
+    // containers are edited through their elements
+    Qt::ItemFlags flags = result->flags(1);
+    const Property &property = context.property();
+    flags.setFlag(Qt::ItemIsEditable, !internal::isReadOnly(property) && PropertyGridTreeItem::isEditableType(property.type()));
+    result->setFlags(1, flags);
+
+    if (m_itemInitializer)
+        m_itemInitializer(result);
+
+    // NOTE: the display text is only known after the item got initialized
+    if (propertyId < 0)
     {
-        m_categoriesMap.clear();
-        m_propertiesMap.clear();
-        m_rootItem->children.clear();
+        result->propertyId = registerProperty(context, searchableText(result));
     }
-    endResetModel();
+    else
+    {
+        result->propertyId = propertyId;
+        m_filterIndex.setText(propertyId, searchableText(result));
+    }
+
+    return result;
 }
 
-void internal::PropertyGridTreeModel::update()
+int internal::PropertyGridTreeModel::registerProperty(const PropertyContext &context, const QString &searchableText)
 {
-    beginResetModel();
+    const int result = m_filterIndex.addText(searchableText);
 
-    // Notify about the structural change
-    emit layoutAboutToBeChanged();
-    emit dataChanged(createIndex(0, 0), createIndex(rowCount(), columnCount()));
-    emit layoutChanged();
+    m_propertyNames.push_back(context.property().name());
+    updateModifiedState(result, context);
 
-    endResetModel();
+    return result;
 }
 
-internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getCategoryItem(const QString &category)
+bool internal::PropertyGridTreeModel::updateModifiedState(int propertyId, const PropertyContext &context)
 {
-    if (m_categoriesMap.contains(category))
-        return m_categoriesMap.value(category);
+    const Property &property = context.property();
+    const bool isModified = property.hasAttribute<DefaultValueAttribute>() && !internal::isDefaultValue(property, context.value());
 
-    const PropertyContext tempCategoryContext = PropertyContextPrivate::createContext(PM::Property(category, QMetaType::UnknownType));
-    PropertyGridTreeItem *result = m_rootItem->addChild(tempCategoryContext);
-    result->isTransient = true;
-    // TODO: make category item expanded by default?!!
+    return m_modifiedProperties.set(propertyId, isModified);
+}
+
+void internal::PropertyGridTreeModel::fetchCategory(PropertyGridTreeItem *categoryItem)
+{
+    if (categoryItem->childrenFetched)
+        return;
 
-    QFont font = QApplication::font(); // TODO: get font from parent PropertyGrid
-    font.setBold(true);
+    categoryItem->childrenFetched = true;
 
-    const QColor inactiveBorderColor =
-        QApplication::palette().color(QPalette::Inactive, QPalette::Window); // TODO: get palette from parent PropertyGrid
+    if (categoryItem->pendingChildren.empty())
+        return;
 
-    result->setDataForAllColumns(Qt::FontRole, font);
-    result->setDataForAllColumns(Qt::BackgroundRole, inactiveBorderColor);
+    const std::vector<PropertyContext> pendingChildren = std::move(categoryItem->pendingChildren);
+    categoryItem->pendingChildren.clear();
 
-    m_categoriesMap.insert(category, result);
+    std::vector<PropertyGridTreeItem *> items;
+    items.reserve(pendingChildren.size());
 
-    return result;
+    for (const PropertyContext &context : pendingChildren)
+    {
+        const int propertyId = m_pendingPropertiesMap.take(context.property().name()).propertyId;
+        items.push_back(createPropertyItem(categoryItem, context, propertyId));
+    }
+
+    insertVisibleRows(categoryItem, items);
+    sortInsertedRows(categoryItem, items);
 }
 
-QVariant internal::PropertyGridTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+QString internal::PropertyGridTreeModel::filterText() const
 {
-    static QStringList headerNames = {"Name", "Value"};
+    return m_filterIndex.query();
+}
 
-    if (section < 0 || section >= columnCount())
-        return QVariant();
+void internal::PropertyGridTreeModel::setFilterText(const QString &text)
+{
+    if (text.toCaseFolded() == m_filterIndex.query())
+        return;
 
-    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
-        return headerNames[section];
+    std::vector<int> changedIds;
+    m_filterIndex.setQuery(text, &changedIds);
 
-    return QVariant();
+    applyFilterChanges(changedIds);
 }
 
-QModelIndex internal::PropertyGridTreeModel::index(int row, int column, const QModelIndex &parent) const
+void internal::PropertyGridTreeModel::refreshPropertyRow(PropertyGridTreeItem *item)
 {
-    if (parent.isValid() && parent.column() != 0)
-        return QModelIndex();
+    if (item->propertyId < 0)
+        return;
 
-    PropertyGridTreeItem *parentItem = getItem(parent);
-    if (parentItem == nullptr)
-        return QModelIndex();
+    m_filterIndex.setText(item->propertyId, searchableText(item));
 
-    PropertyGridTreeItem *childItem = parentItem->getChild(row, m_showCategories);
-    if (childItem != nullptr)
-        return createIndex(row, column, childItem);
+    if (item->propertyId < int(m_sortKeys.size()))
+        m_sortKeys[item->propertyId].reset();
 
-    return QModelIndex();
+    if (updateModifiedState(item->propertyId, item->context))
+        notifyItemDataChanged(item, 1, {Qt::FontRole});
+
+    if (!updatePropertyRowVisibility(item))
+        sortVisibleRow(item);
 }
 
-bool internal::PropertyGridTreeModel::insertRows(int position, int rows, const QModelIndex &parent)
+void internal::PropertyGridTreeModel::refreshPropertyRows(const std::vector<PropertyGridTreeItem *> &items)
 {
-    PropertyGridTreeItem *parentItem = getItem(parent);
-    if (!parentItem)
-        return false;
+    std::vector<PropertyGridTreeItem *> fontChangedItems;
+    std::vector<PropertyGridTreeItem *> remainingItems;
 
-    beginInsertRows(parent, position, position + rows - 1);
-    const bool result = parentItem->insertChildren(position, rows, columnCount());
-    endInsertRows();
+    for (PropertyGridTreeItem *item : items)
+    {
+        if (item->propertyId < 0)
+            continue;
+
+        m_filterIndex.setText(item->propertyId, searchableText(item));
+
+        if (item->propertyId < int(m_sortKeys.size()))
+            m_sortKeys[item->propertyId].reset();
+
+        if (updateModifiedState(item->propertyId, item->context))
+            fontChangedItems.push_back(item);
+    }
+
+    notifyItemsDataChanged(fontChangedItems, 1, {Qt::FontRole});
+
+    // NOTE: the sort keys of all the items must be up to date before any of them gets compared. the rows that got
+    //       filtered in are sorted by updatePropertyRowVisibility(), the others are re-sorted once per parent
+    for (PropertyGridTreeItem *item : items)
+    {
+        if (item->propertyId >= 0 && !updatePropertyRowVisibility(item) && item->visibleRow >= 0)
+            remainingItems.push_back(item);
+    }
+
+    std::unordered_set<PropertyGridTreeItem *> unsortedParents;
+    for (PropertyGridTreeItem *item : remainingItems)
+    {
+        if (!isSortedAt(item))
+            unsortedParents.insert(m_showCategories ? item->parent : m_rootItem);
+    }
+
+    for (PropertyGridTreeItem *parentItem : unsortedParents)
+        sortVisibleRows(parentItem);
+}
+
+void internal::PropertyGridTreeModel::refreshPendingProperty(const QString &propertyName)
+{
+    auto it = m_pendingPropertiesMap.constFind(propertyName);
+    if (it == m_pendingPropertiesMap.constEnd())
+        return;
+
+    updateModifiedState(it->propertyId, it->categoryItem->pendingChildren[it->index]);
+}
+
+int internal::PropertyGridTreeModel::modifiedPropertiesCount() const
+{
+    return m_modifiedProperties.count();
+}
+
+void internal::PropertyGridTreeModel::forEachModifiedProperty(const std::function<void(const QString &propertyName)> &function) const
+{
+    m_modifiedProperties.forEach(
+        [this, &function](int propertyId)
+        {
+            //
+            function(m_propertyNames[propertyId]);
+        });
+}
+
+void internal::PropertyGridTreeModel::setItemHidden(PropertyGridTreeItem *item, bool hidden)
+{
+    if (item->isHidden == hidden)
+        return;
+
+    item->isHidden = hidden;
+
+    updatePropertyRowVisibility(item);
+}
+
+bool internal::PropertyGridTreeModel::updatePropertyRowVisibility(PropertyGridTreeItem *item)
+{
+    const bool isAccepted = isItemAccepted(item);
+    const bool isVisible = item->visibleRow >= 0;
+
+    if (isAccepted && !isVisible)
+    {
+        const bool isCategoryShown = item->parent->visibleRow >= 0;
+
+        showPropertyRow(item);
+        sortVisibleRow(item);
+
+        if (!isCategoryShown)
+            sortCategoryRow(item->parent);
+
+        return true;
+    }
+
+    if (!isAccepted && isVisible)
+    {
+        hidePropertyRow(item);
+
+        return true;
+    }
+
+    return false;
+}
+
+PropertyGrid::SortMode internal::PropertyGridTreeModel::sortMode() const
+{
+    return m_sortMode;
+}
+
+void internal::PropertyGridTreeModel::setSortMode(PropertyGrid::SortMode mode)
+{
+    if (m_sortMode == mode)
+        return;
+
+    m_sortMode = mode;
+
+    relayoutVisibleRows();
+}
+
+QString internal::PropertyGridTreeModel::searchableText(PropertyGridTreeItem *item) const
+{
+    ensureDisplayData(item);
+
+    return searchableText(item->context.property(), item->getColumnData(1, Qt::DisplayRole).toString());
+}
+
+QString internal::PropertyGridTreeModel::searchableText(const Property &property, const QString &value)
+{
+    QString description;
+    if (property.hasAttribute<DescriptionAttribute>())
+        description = property.getAttribute<DescriptionAttribute>().value;
+
+    const QString name = property.name();
+
+    // this runs whenever a value changes, the text is put together in a single allocation
+    QString result;
+    result.reserve(name.size() + description.size() + value.size() + 2);
+    result.append(name).append(QLatin1Char('\n')).append(description).append(QLatin1Char('\n')).append(value);
 
     return result;
 }
 
-QModelIndex internal::PropertyGridTreeModel::parent(const QModelIndex &index) const
+bool internal::PropertyGridTreeModel::isItemAccepted(const PropertyGridTreeItem *item) const
 {
-    // FIXME: handle m_showCategories
+    return !item->isHidden && (item->propertyId < 0 || m_filterIndex.matches(item->propertyId));
+}
 
-    if (!index.isValid())
-        return QModelIndex();
+bool internal::PropertyGridTreeModel::isItemShown(const PropertyGridTreeItem *item) const
+{
+    for (; item != m_rootItem; item = item->parent)
+    {
+        if (item->isElement())
+            continue;
 
-    PropertyGridTreeItem *childItem = getItem(index);
-    PropertyGridTreeItem *parentItem = childItem ? childItem->parent : nullptr;
+        if (item->visibleRow < 0)
+            return false;
 
-    if (parentItem == m_rootItem || !parentItem)
-        return QModelIndex();
+        // properties are rows of the root when categories are flattened
+        if (!m_showCategories)
+            return true;
+    }
+
+    return true;
+}
+
+bool internal::PropertyGridTreeModel::isCategoryAccepted(const PropertyGridTreeItem *categoryItem) const
+{
+    // empty categories are hidden, unless they weren't fetched yet
+    return !categoryItem->visibleChildren.empty() || isPendingCategoryAccepted(categoryItem);
+}
+
+bool internal::PropertyGridTreeModel::isPendingCategoryAccepted(const PropertyGridTreeItem *categoryItem) const
+{
+    if (categoryItem->childrenFetched)
+        return false;
+
+    if (!m_filterIndex.isActive())
+        return true;
+
+    const auto isAccepted = [this](const PropertyContext &context)
+    {
+        //
+        return m_filterIndex.matches(m_pendingPropertiesMap.value(context.property().name()).propertyId);
+    };
+
+    return std::any_of(categoryItem->pendingChildren.begin(), categoryItem->pendingChildren.end(), isAccepted);
+}
+
+void internal::PropertyGridTreeModel::rebuildVisibleRows()
+{
+    // NOTE: this doesn't notify the view, callers are expected to wrap it in a reset or a layout change
+    rebuildVisibleRows(m_rootItem);
+
+    // flat lists sorted by name or value don't keep the properties of a category together
+    if (!m_showCategories && m_sortMode != PropertyGrid::SortMode::CategoryOrder)
+        sortRows(m_rootItem->visibleChildren);
+
+    updateVisibleRows(m_rootItem, 0);
+}
+
+void internal::PropertyGridTreeModel::rebuildVisibleRows(PropertyGridTreeItem *categoryItem)
+{
+    // the visible properties of a category come first, followed by its visible subcategories. in flat mode the
+    // properties are appended to the rows of the root instead, which lists them in depth first order
+    std::vector<PropertyGridTreeItem *> &rows = categoryItem->visibleChildren;
+    rows.clear();
+
+    std::vector<PropertyGridTreeItem *> subcategories;
+
+    for (const auto &child : categoryItem->children)
+    {
+        child->visibleRow = -1;
+
+        if (child->isTransient)
+            subcategories.push_back(child.get());
+        else if (isItemAccepted(child.get()))
+            rows.push_back(child.get());
+    }
+
+    sortRows(rows);
+    sortRows(subcategories);
 
-    size_t indexInParent = parentItem->indexInParent(m_showCategories);
+    if (!m_showCategories && categoryItem != m_rootItem)
+        m_rootItem->visibleChildren.insert(m_rootItem->visibleChildren.end(), rows.begin(), rows.end());
+
+    for (PropertyGridTreeItem *subcategory : subcategories)
+    {
+        rebuildVisibleRows(subcategory);
+
+        if (m_showCategories && isCategoryAccepted(subcategory))
+            rows.push_back(subcategory);
+    }
+
+    // categories are transient in flat mode, they only keep track of which of their properties are visible
+    if (m_showCategories)
+        updateVisibleRows(categoryItem, 0);
+}
+
+void internal::PropertyGridTreeModel::relayoutVisibleRows()
+{
+    emit layoutAboutToBeChanged();
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+
+    rebuildVisibleRows();
+    changePersistentRows(oldIndexes);
+
+    emit layoutChanged();
+}
+
+void internal::PropertyGridTreeModel::changePersistentRows(const QModelIndexList &oldIndexes)
+{
+    // NOTE: the items of the old indexes are still alive, only their rows changed
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+
+    for (const QModelIndex &oldIndex : oldIndexes)
+    {
+        PropertyGridTreeItem *item = getItem(oldIndex);
+
+        if (isItemShown(item))
+            newIndexes.append(PM::internal::siblingAtColumn(getItemIndex(item), oldIndex.column()));
+        else
+            newIndexes.append(QModelIndex());
+    }
+
+    changePersistentIndexList(oldIndexes, newIndexes);
+}
+
+void internal::PropertyGridTreeModel::applyFilterChanges(const std::vector<int> &changedIds)
+{
+    // the properties that entered the matches, by category. pending properties only change the visibility of their category
+    std::unordered_map<PropertyGridTreeItem *, std::vector<PropertyGridTreeItem *>> enteredItems;
+
+    for (int propertyId : changedIds)
+    {
+        const QString &name = m_propertyNames[propertyId];
+
+        PropertyGridTreeItem *item = m_propertiesMap.value(name);
+        if (item != nullptr)
+        {
+            std::vector<PropertyGridTreeItem *> &items = enteredItems[item->parent];
+
+            if (item->visibleRow < 0 && isItemAccepted(item))
+                items.push_back(item);
+
+            continue;
+        }
+
+        auto it = m_pendingPropertiesMap.constFind(name);
+        if (it != m_pendingPropertiesMap.constEnd())
+            enteredItems.try_emplace(it->categoryItem);
+    }
+
+    if (enteredItems.empty())
+        return;
+
+    // the visibility of a category changes the rows of its parent, so the ancestors get updated after their descendants
+    std::vector<std::pair<int, PropertyGridTreeItem *>> categories;
+    std::unordered_set<PropertyGridTreeItem *> visitedCategories;
+
+    for (const auto &entry : enteredItems)
+    {
+        for (PropertyGridTreeItem *categoryItem = entry.first; categoryItem != nullptr; categoryItem = categoryItem->parent)
+        {
+            if (!visitedCategories.insert(categoryItem).second)
+                break;
+
+            int depth = 0;
+            for (const PropertyGridTreeItem *item = categoryItem; item != m_rootItem; item = item->parent)
+                depth++;
+
+            categories.emplace_back(depth, categoryItem);
+
+            // categories are transient in flat mode, the root gets its rows from all of them at once
+            if (!m_showCategories)
+                break;
+        }
+    }
+
+    std::sort(categories.begin(), categories.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    QList<QPersistentModelIndex> parents;
+    if (m_showCategories)
+    {
+        for (const auto &category : categories)
+        {
+            if (category.second == m_rootItem || isItemShown(category.second))
+                parents.append(QPersistentModelIndex(getItemIndex(category.second)));
+        }
+    }
+    else
+    {
+        parents.append(QPersistentModelIndex());
+    }
+
+    emit layoutAboutToBeChanged(parents);
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+
+    std::vector<PropertyGridTreeItem *> flatEnteredItems;
+
+    for (const auto &category : categories)
+    {
+        std::vector<PropertyGridTreeItem *> &items = enteredItems[category.second];
+
+        updateFilteredRows(category.second, items);
+
+        if (!m_showCategories)
+            flatEnteredItems.insert(flatEnteredItems.end(), items.begin(), items.end());
+    }
+
+    if (!m_showCategories)
+        updateFlatFilteredRows(flatEnteredItems);
+
+    changePersistentRows(oldIndexes);
+
+    emit layoutChanged(parents);
+}
+
+void internal::PropertyGridTreeModel::updateFilteredRows(PropertyGridTreeItem *categoryItem, std::vector<PropertyGridTreeItem *> &enteredItems)
+{
+    // NOTE: the properties that stay visible are still sorted, the ones that entered get sorted on their own and merged in
+    std::vector<PropertyGridTreeItem *> &rows = categoryItem->visibleChildren;
+    std::vector<PropertyGridTreeItem *> properties;
+    properties.reserve(rows.size() + enteredItems.size());
+
+    for (PropertyGridTreeItem *row : rows)
+    {
+        // the properties of flat lists are rows of the root, see updateFlatFilteredRows()
+        if (m_showCategories)
+            row->visibleRow = -1;
+
+        if (!row->isTransient && isItemAccepted(row))
+            properties.push_back(row);
+    }
+
+    // NOTE: the order of the properties of a category only matters when the category itself is shown, or when the
+    //       flat list keeps the properties of each category together
+    const bool isSorted = m_sortMode == PropertyGrid::SortMode::NameOrder || m_sortMode == PropertyGrid::SortMode::ValueOrder;
+
+    if (isSorted && m_showCategories)
+    {
+        mergeRows(properties, enteredItems);
+    }
+    else if (!enteredItems.empty())
+    {
+        properties.clear();
+
+        for (const auto &child : categoryItem->children)
+        {
+            if (!child->isTransient && isItemAccepted(child.get()))
+                properties.push_back(child.get());
+        }
+    }
+
+    rows.swap(properties);
+
+    // categories are transient in flat mode, they only keep track of which of their properties are visible
+    if (!m_showCategories)
+        return;
+
+    std::vector<PropertyGridTreeItem *> subcategories;
+    for (const auto &child : categoryItem->children)
+    {
+        if (child->isTransient && isCategoryAccepted(child.get()))
+            subcategories.push_back(child.get());
+    }
+
+    sortRows(subcategories);
+
+    rows.insert(rows.end(), subcategories.begin(), subcategories.end());
+    updateVisibleRows(categoryItem, 0);
+}
+
+void internal::PropertyGridTreeModel::updateFlatFilteredRows(std::vector<PropertyGridTreeItem *> &enteredItems)
+{
+    std::vector<PropertyGridTreeItem *> &rows = m_rootItem->visibleChildren;
+    std::vector<PropertyGridTreeItem *> result;
+    result.reserve(rows.size() + enteredItems.size());
+
+    for (PropertyGridTreeItem *row : rows)
+    {
+        row->visibleRow = -1;
+
+        if (isItemAccepted(row))
+            result.push_back(row);
+    }
+
+    // flat lists sorted by name or value don't keep the properties of a category together
+    if (m_sortMode == PropertyGrid::SortMode::NameOrder || m_sortMode == PropertyGrid::SortMode::ValueOrder)
+    {
+        mergeRows(result, enteredItems);
+    }
+    else if (!enteredItems.empty())
+    {
+        result.clear();
+        appendFlatRows(m_rootItem, result);
+    }
+
+    rows.swap(result);
+    updateVisibleRows(m_rootItem, 0);
+}
+
+void internal::PropertyGridTreeModel::appendFlatRows(const PropertyGridTreeItem *parentItem, std::vector<PropertyGridTreeItem *> &rows) const
+{
+    // NOTE: walks the categories in the same depth first (and sorted) order as rebuildVisibleRows()
+    std::vector<PropertyGridTreeItem *> subcategories;
+    for (const auto &child : parentItem->children)
+    {
+        if (child->isTransient)
+            subcategories.push_back(child.get());
+    }
+
+    sortRows(subcategories);
+
+    for (const PropertyGridTreeItem *subcategory : subcategories)
+    {
+        rows.insert(rows.end(), subcategory->visibleChildren.begin(), subcategory->visibleChildren.end());
+        appendFlatRows(subcategory, rows);
+    }
+}
+
+void internal::PropertyGridTreeModel::updateVisibleRows(PropertyGridTreeItem *parentItem, int first)
+{
+    std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+
+    for (int row = first; row < int(rows.size()); ++row)
+        rows[row]->visibleRow = row;
+}
+
+int internal::PropertyGridTreeModel::visibleInsertPosition(const PropertyGridTreeItem *parentItem, const PropertyGridTreeItem *item) const
+{
+    // the number of visible siblings that come before the given item, the properties being listed before the subcategories
+    int result = 0;
+    bool isBefore = true;
+
+    for (const auto &child : parentItem->children)
+    {
+        if (child.get() == item)
+        {
+            isBefore = false;
+            continue;
+        }
+
+        if (child->visibleRow < 0)
+            continue;
+
+        if (child->isTransient ? item->isTransient && isBefore : isBefore || item->isTransient)
+            result++;
+    }
+
+    return result;
+}
+
+int internal::PropertyGridTreeModel::flatRowPosition(const PropertyGridTreeItem *categoryItem) const
+{
+    // the row right after the last visible property of the given category when categories are flattened
+    int result = 0;
+    flatRowPosition(m_rootItem, categoryItem, result);
+
+    return result;
+}
+
+bool internal::PropertyGridTreeModel::flatRowPosition(const PropertyGridTreeItem *parentItem, const PropertyGridTreeItem *categoryItem,
+                                                      int &result) const
+{
+    // NOTE: walks the categories in the same depth first (and sorted) order as rebuildVisibleRows(), only categories get visited
+    std::vector<PropertyGridTreeItem *> subcategories;
+    for (const auto &child : parentItem->children)
+    {
+        if (child->isTransient)
+            subcategories.push_back(child.get());
+    }
+
+    sortRows(subcategories);
+
+    for (const PropertyGridTreeItem *subcategory : subcategories)
+    {
+        result += int(subcategory->visibleChildren.size());
+
+        if (subcategory == categoryItem || flatRowPosition(subcategory, categoryItem, result))
+            return true;
+    }
+
+    return false;
+}
+
+void internal::PropertyGridTreeModel::insertVisibleRows(PropertyGridTreeItem *categoryItem, const std::vector<PropertyGridTreeItem *> &items)
+{
+    // NOTE: the items were just appended to the category, the accepted ones become its last visible properties
+    std::vector<PropertyGridTreeItem *> acceptedItems;
+    acceptedItems.reserve(items.size());
+
+    for (PropertyGridTreeItem *item : items)
+    {
+        if (isItemAccepted(item))
+            acceptedItems.push_back(item);
+    }
+
+    if (acceptedItems.empty())
+        return;
+
+    std::vector<PropertyGridTreeItem *> &categoryRows = categoryItem->visibleChildren;
+    const int count = int(acceptedItems.size());
+
+    // categories are transient in flat mode, their properties get inserted directly under the root
+    if (!m_showCategories)
+    {
+        std::vector<PropertyGridTreeItem *> &rootRows = m_rootItem->visibleChildren;
+        const int first = flatRowPosition(categoryItem);
+
+        beginInsertRows(QModelIndex(), first, first + count - 1);
+        categoryRows.insert(categoryRows.end(), acceptedItems.begin(), acceptedItems.end());
+        rootRows.insert(rootRows.begin() + first, acceptedItems.begin(), acceptedItems.end());
+        updateVisibleRows(m_rootItem, first);
+        endInsertRows();
+
+        return;
+    }
+
+    const auto subcategoriesIt =
+        std::find_if(categoryRows.begin(), categoryRows.end(), [](const PropertyGridTreeItem *item) { return item->isTransient; });
+    const int first = int(subcategoriesIt - categoryRows.begin());
+
+    // the category row gets inserted along with its first visible children
+    if (categoryItem->visibleRow < 0)
+    {
+        categoryRows.insert(subcategoriesIt, acceptedItems.begin(), acceptedItems.end());
+        updateVisibleRows(categoryItem, first);
+        showCategoryRow(categoryItem);
+
+        return;
+    }
+
+    beginInsertRows(getItemIndex(categoryItem), first, first + count - 1);
+    categoryRows.insert(subcategoriesIt, acceptedItems.begin(), acceptedItems.end());
+    updateVisibleRows(categoryItem, first);
+    endInsertRows();
+}
+
+void internal::PropertyGridTreeModel::showCategoryRow(PropertyGridTreeItem *categoryItem)
+{
+    // NOTE: categories only have rows of their own when they are shown
+    if (!m_showCategories || categoryItem->visibleRow >= 0)
+        return;
+
+    PropertyGridTreeItem *parentItem = categoryItem->parent;
+    std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+    const int row = visibleInsertPosition(parentItem, categoryItem);
+
+    // a hidden parent category gets inserted along with it
+    if (parentItem != m_rootItem && parentItem->visibleRow < 0)
+    {
+        rows.insert(rows.begin() + row, categoryItem);
+        updateVisibleRows(parentItem, row);
+        showCategoryRow(parentItem);
+
+        return;
+    }
+
+    beginInsertRows(getItemIndex(parentItem), row, row);
+    rows.insert(rows.begin() + row, categoryItem);
+    updateVisibleRows(parentItem, row);
+    endInsertRows();
+}
+
+void internal::PropertyGridTreeModel::showPropertyRow(PropertyGridTreeItem *item)
+{
+    PropertyGridTreeItem *categoryItem = item->parent;
+    std::vector<PropertyGridTreeItem *> &categoryRows = categoryItem->visibleChildren;
+    const int position = visibleInsertPosition(categoryItem, item);
+
+    if (!m_showCategories)
+    {
+        std::vector<PropertyGridTreeItem *> &rootRows = m_rootItem->visibleChildren;
+        const int row = flatRowPosition(categoryItem) - int(categoryRows.size()) + position;
+
+        beginInsertRows(QModelIndex(), row, row);
+        categoryRows.insert(categoryRows.begin() + position, item);
+        rootRows.insert(rootRows.begin() + row, item);
+        updateVisibleRows(m_rootItem, row);
+        endInsertRows();
+
+        return;
+    }
+
+    if (categoryItem->visibleRow < 0)
+    {
+        categoryRows.insert(categoryRows.begin() + position, item);
+        updateVisibleRows(categoryItem, position);
+        showCategoryRow(categoryItem);
+
+        return;
+    }
+
+    beginInsertRows(getItemIndex(categoryItem), position, position);
+    categoryRows.insert(categoryRows.begin() + position, item);
+    updateVisibleRows(categoryItem, position);
+    endInsertRows();
+}
+
+void internal::PropertyGridTreeModel::hidePropertyRow(PropertyGridTreeItem *item)
+{
+    if (!m_showCategories)
+    {
+        std::vector<PropertyGridTreeItem *> &categoryRows = item->parent->visibleChildren;
+        std::vector<PropertyGridTreeItem *> &rootRows = m_rootItem->visibleChildren;
+        const int row = item->visibleRow;
+
+        beginRemoveRows(QModelIndex(), row, row);
+        categoryRows.erase(std::find(categoryRows.begin(), categoryRows.end(), item));
+        rootRows.erase(rootRows.begin() + row);
+        item->visibleRow = -1;
+        updateVisibleRows(m_rootItem, row);
+        endRemoveRows();
+
+        return;
+    }
+
+    hideVisibleRow(item);
+}
+
+void internal::PropertyGridTreeModel::hideVisibleRow(PropertyGridTreeItem *item)
+{
+    PropertyGridTreeItem *parentItem = item->parent;
+    std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+
+    // a category that has no visible rows left goes away along with the last one
+    if (parentItem != m_rootItem && rows.size() == 1 && !isPendingCategoryAccepted(parentItem))
+    {
+        hideVisibleRow(parentItem);
+
+        rows.clear();
+        item->visibleRow = -1;
+
+        return;
+    }
+
+    const int row = item->visibleRow;
+
+    beginRemoveRows(getItemIndex(parentItem), row, row);
+    rows.erase(rows.begin() + row);
+    item->visibleRow = -1;
+    updateVisibleRows(parentItem, row);
+    endRemoveRows();
+}
+
+void internal::PropertyGridTreeModel::sortVisibleRow(PropertyGridTreeItem *item)
+{
+    if (item->visibleRow < 0 || isSortedAt(item))
+        return;
+
+    PropertyGridTreeItem *parentItem = m_showCategories ? item->parent : m_rootItem;
+    std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+
+    // properties are sorted among the properties, subcategories among the subcategories that follow them
+    const auto isTransient = [](const PropertyGridTreeItem *row) { return row->isTransient; };
+    const auto subcategoriesIt = std::find_if(rows.begin(), rows.end(), isTransient);
+    const auto sectionBegin = item->isTransient ? subcategoriesIt : rows.begin();
+    const auto sectionEnd = item->isTransient ? rows.end() : subcategoriesIt;
+    const auto compare = [this](const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) { return lessThan(a, b); };
+
+    const int from = item->visibleRow;
+    const auto fromIt = rows.begin() + from;
+
+    // NOTE: the destination of beginMoveRows() is the row the moved one gets inserted before, in terms of the old rows
+    int to = 0;
+    int destination = 0;
+
+    if (from > 0 && rows[from - 1]->isTransient == item->isTransient && lessThan(item, rows[from - 1]))
+    {
+        to = int(std::upper_bound(sectionBegin, fromIt, item, compare) - rows.begin());
+        destination = to;
+    }
+    else
+    {
+        to = int(std::upper_bound(fromIt + 1, sectionEnd, item, compare) - rows.begin()) - 1;
+        destination = to + 1;
+    }
+
+    // the rows of categories that aren't shown are unknown to the view
+    const bool isParentShown = parentItem == m_rootItem || isItemShown(parentItem);
+    const QModelIndex parentIndex = getItemIndex(parentItem);
+
+    if (isParentShown)
+        beginMoveRows(parentIndex, from, from, parentIndex, destination);
+
+    if (to < from)
+        std::rotate(rows.begin() + to, fromIt, fromIt + 1);
+    else
+        std::rotate(fromIt, fromIt + 1, rows.begin() + to + 1);
+
+    updateVisibleRows(parentItem, std::min(from, to));
+
+    if (isParentShown)
+        endMoveRows();
+}
+
+void internal::PropertyGridTreeModel::sortCategoryRow(PropertyGridTreeItem *categoryItem)
+{
+    if (!m_showCategories)
+        return;
+
+    // NOTE: the ancestors that got shown along with the category come first, the rows of their parents are sorted
+    std::vector<PropertyGridTreeItem *> categories;
+    for (PropertyGridTreeItem *item = categoryItem; item != m_rootItem; item = item->parent)
+        categories.push_back(item);
+
+    for (auto it = categories.rbegin(); it != categories.rend(); ++it)
+        sortVisibleRow(*it);
+}
+
+void internal::PropertyGridTreeModel::sortVisibleRows(PropertyGridTreeItem *parentItem)
+{
+    if (m_sortMode == PropertyGrid::SortMode::InsertionOrder)
+        return;
+
+    std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+
+    const auto isTransient = [](const PropertyGridTreeItem *row) { return row->isTransient; };
+    const auto compare = [this](const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) { return lessThan(a, b); };
+    const auto subcategoriesIt = std::find_if(rows.begin(), rows.end(), isTransient);
+
+    if (std::is_sorted(rows.begin(), subcategoriesIt, compare) && std::is_sorted(subcategoriesIt, rows.end(), compare))
+        return;
+
+    // the rows of categories that aren't shown are unknown to the view
+    if (parentItem != m_rootItem && !isItemShown(parentItem))
+    {
+        std::stable_sort(rows.begin(), subcategoriesIt, compare);
+        std::stable_sort(subcategoriesIt, rows.end(), compare);
+        updateVisibleRows(parentItem, 0);
+
+        return;
+    }
+
+    const QModelIndex parentIndex = getItemIndex(parentItem);
+
+    emit layoutAboutToBeChanged({QPersistentModelIndex(parentIndex)}, QAbstractItemModel::VerticalSortHint);
+
+    // only the persistent indexes of the rows that get moved around need to be updated
+    QModelIndexList oldIndexes;
+    std::vector<PropertyGridTreeItem *> oldItems;
+
+    for (const QModelIndex &index : persistentIndexList())
+    {
+        if (index.parent() != parentIndex)
+            continue;
+
+        oldIndexes.append(index);
+        oldItems.push_back(getItem(index));
+    }
+
+    // stable, so that equal rows keep their insertion order
+    std::stable_sort(rows.begin(), subcategoriesIt, compare);
+    std::stable_sort(subcategoriesIt, rows.end(), compare);
+    updateVisibleRows(parentItem, 0);
+
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+
+    for (int i = 0; i < oldIndexes.size(); ++i)
+        newIndexes.append(PM::internal::siblingAtColumn(getItemIndex(oldItems[i]), oldIndexes[i].column()));
+
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged({QPersistentModelIndex(parentIndex)}, QAbstractItemModel::VerticalSortHint);
+}
+
+void internal::PropertyGridTreeModel::sortInsertedRows(PropertyGridTreeItem *categoryItem, const std::vector<PropertyGridTreeItem *> &items)
+{
+    // NOTE: a few rows are moved one at a time, which doesn't disturb the rest of the view. larger batches get their
+    //       parent sorted as a whole
+    const size_t movedRowsLimit = 8;
+
+    if (m_sortMode == PropertyGrid::SortMode::InsertionOrder)
+        return;
+
+    sortCategoryRow(categoryItem);
+
+    if (items.size() <= movedRowsLimit)
+    {
+        for (PropertyGridTreeItem *item : items)
+            sortVisibleRow(item);
+    }
+    else
+    {
+        sortVisibleRows(m_showCategories ? categoryItem : m_rootItem);
+    }
+}
+
+void internal::PropertyGridTreeModel::sortRows(std::vector<PropertyGridTreeItem *> &rows) const
+{
+    if (m_sortMode == PropertyGrid::SortMode::InsertionOrder)
+        return;
+
+    // stable, so that equal rows keep their insertion order
+    std::stable_sort(rows.begin(), rows.end(), [this](const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) { return lessThan(a, b); });
+}
+
+void internal::PropertyGridTreeModel::mergeRows(std::vector<PropertyGridTreeItem *> &rows, std::vector<PropertyGridTreeItem *> &otherRows) const
+{
+    if (otherRows.empty())
+        return;
+
+    sortRows(otherRows);
+
+    std::vector<PropertyGridTreeItem *> result;
+    result.reserve(rows.size() + otherRows.size());
+
+    std::merge(rows.begin(), rows.end(), otherRows.begin(), otherRows.end(), std::back_inserter(result),
+               [this](const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) { return lessThan(a, b); });
+
+    rows.swap(result);
+}
+
+bool internal::PropertyGridTreeModel::isSortedAt(const PropertyGridTreeItem *item) const
+{
+    if (m_sortMode == PropertyGrid::SortMode::InsertionOrder)
+        return true;
+
+    const PropertyGridTreeItem *parentItem = m_showCategories ? item->parent : m_rootItem;
+    const std::vector<PropertyGridTreeItem *> &rows = parentItem->visibleChildren;
+    const int row = item->visibleRow;
+
+    // NOTE: the subcategories that follow the properties of a category are sorted separately
+    if (row > 0 && rows[row - 1]->isTransient == item->isTransient && lessThan(item, rows[row - 1]))
+        return false;
+
+    if (row + 1 < int(rows.size()) && rows[row + 1]->isTransient == item->isTransient && lessThan(rows[row + 1], item))
+        return false;
+
+    return true;
+}
+
+bool internal::PropertyGridTreeModel::lessThan(const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) const
+{
+    // categories are sorted by name in every mode but the insertion order
+    if (a->isTransient || b->isTransient)
+        return m_collator.compare(a->context.property().name(), b->context.property().name()) < 0;
+
+    switch (m_sortMode)
+    {
+    case PropertyGrid::SortMode::InsertionOrder:
+    case PropertyGrid::SortMode::CategoryOrder:
+        return false;
+
+    case PropertyGrid::SortMode::NameOrder:
+        return sortKey(a).name.compare(sortKey(b).name) < 0;
+
+    case PropertyGrid::SortMode::ValueOrder:
+    {
+        const PropertySortKey &keyA = sortKey(a);
+        const PropertySortKey &keyB = sortKey(b);
+
+        // numbers come first and get compared by value, everything else by its displayed text
+        if (keyA.isNumber != keyB.isNumber)
+            return keyA.isNumber;
+
+        if (keyA.isNumber && keyA.number != keyB.number)
+            return keyA.number < keyB.number;
+
+        const int result = keyA.isNumber ? 0 : keyA.value.compare(keyB.value);
+        if (result != 0)
+            return result < 0;
+
+        return keyA.name.compare(keyB.name) < 0;
+    }
+    }
+
+    return false;
+}
+
+const internal::PropertyGridTreeModel::PropertySortKey &internal::PropertyGridTreeModel::sortKey(const PropertyGridTreeItem *item) const
+{
+    // NOTE: keys are created the first time a property gets sorted, and dropped when its value changes
+    if (item->propertyId >= int(m_sortKeys.size()))
+        m_sortKeys.resize(m_filterIndex.count());
+
+    std::optional<PropertySortKey> &result = m_sortKeys[item->propertyId];
+    if (result)
+        return *result;
+
+    ensureDisplayData(const_cast<PropertyGridTreeItem *>(item));
+
+    const QVariant value = item->context.value();
+    bool isNumber = false;
+
+    switch (PM::internal::getVariantTypeId(value))
+    {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+        isNumber = true;
+        break;
+
+    default:
+        break;
+    }
+
+    result.emplace(PropertySortKey{m_collator.sortKey(item->context.property().name()),
+                                   m_collator.sortKey(item->getColumnData(1, Qt::DisplayRole).toString()), isNumber ? value.toDouble() : 0.0,
+                                   isNumber});
+
+    return *result;
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getElementItem(PropertyGridTreeItem *containerItem, int index) const
+{
+    if (index < 0 || index >= containerItem->elementsCount)
+        return nullptr;
+
+    auto it = containerItem->elementItems.find(index);
+    if (it != containerItem->elementItems.end())
+        return it->second.get();
+
+    PropertyGridTreeItem *result = containerItem->createElement(index);
+    m_nestedItemsMap.insert(&result->context, result);
+    watchValueObject(result);
+
+    // NOTE: this runs for every row the view walks over, the displayed data waits until it's asked for
+    if (m_elementItemInitializer)
+        m_elementItemInitializer(result);
+
+    return result;
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getNestedItem(const PropertyContext &context) const
+{
+    return m_nestedItemsMap.value(&context);
+}
+
+void internal::PropertyGridTreeModel::updateElements(PropertyGridTreeItem *containerItem)
+{
+    // NOTE: the value just got set, it may reference another object now
+    containerItem->trackValueObject();
+    watchValueObject(containerItem);
+
+    updateElementRows(containerItem);
+}
+
+void internal::PropertyGridTreeModel::updateElementRows(PropertyGridTreeItem *containerItem)
+{
+    const int oldCount = containerItem->elementsCount;
+    const int newCount = containerItem->valueElementsCount();
+
+    if (oldCount == 0 && newCount == 0)
+        return;
+
+    const QStringList newKeys = containerItem->valueElementKeys();
+    const CompositeTypePlan *newPlan = containerItem->valueCompositePlan();
+
+    // same rows, only the elements that were already accessed need to pick up their new values
+    if (oldCount == newCount && containerItem->elementKeys == newKeys && containerItem->compositePlan == newPlan)
+    {
+        for (const auto &entry : containerItem->elementItems)
+        {
+            PropertyGridTreeItem *elementItem = entry.second.get();
+            PropertyContextPrivate::setValue(elementItem->context, containerItem->elementValue(entry.first));
+
+            // the rows that are shown ask for their new data once they get notified, the others never do
+            if (m_elementItemInitializer)
+                m_elementItemInitializer(elementItem);
+
+            notifyItemDataChanged(elementItem, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+            updateElements(elementItem);
+        }
+
+        return;
+    }
+
+    // NOTE: the view doesn't know about the rows of containers that are filtered out
+    const bool isShown = isItemShown(containerItem);
+    const QModelIndex containerIndex = getItemIndex(containerItem);
+
+    if (oldCount > 0)
+    {
+        if (isShown)
+            beginRemoveRows(containerIndex, 0, oldCount - 1);
+
+        unregisterNestedItems(containerItem);
+        containerItem->elementItems.clear();
+        containerItem->elementsCount = 0;
+        containerItem->elementKeys.clear();
+
+        if (isShown)
+            endRemoveRows();
+    }
+
+    containerItem->compositePlan = newPlan;
+
+    if (newCount > 0)
+    {
+        if (isShown)
+            beginInsertRows(containerIndex, 0, newCount - 1);
+
+        containerItem->elementsCount = newCount;
+        containerItem->elementKeys = newKeys;
+
+        if (isShown)
+            endInsertRows();
+    }
+}
+
+void internal::PropertyGridTreeModel::watchValueObject(const PropertyGridTreeItem *item) const
+{
+    QObject *object = item->valueObject();
+    if (object == nullptr)
+        return;
+
+    connect(object, &QObject::destroyed, this, &PropertyGridTreeModel::scheduleDestroyedObjectsCleanup, Qt::UniqueConnection);
+}
+
+void internal::PropertyGridTreeModel::scheduleDestroyedObjectsCleanup()
+{
+    // NOTE: deleting an object tree deletes many objects in a row, they all get handled by a single walk
+    if (m_isDestroyedObjectsCleanupScheduled)
+        return;
+
+    m_isDestroyedObjectsCleanupScheduled = true;
+
+    QTimer::singleShot(0, this,
+                       [this]()
+                       {
+                           m_isDestroyedObjectsCleanupScheduled = false;
+
+                           for (PropertyGridTreeItem *item : m_propertiesMap)
+                               dropDestroyedObjectRows(item);
+                       });
+}
+
+void internal::PropertyGridTreeModel::dropDestroyedObjectRows(PropertyGridTreeItem *item)
+{
+    // the value keeps pointing to the deleted object, it gets shown as null without any sub-rows
+    if (item->isValueObjectDestroyed())
+    {
+        // items that were already dropped before
+        if (item->compositePlan == nullptr)
+            return;
+
+        updateElementRows(item);
+
+        if (m_itemInitializer)
+            m_itemInitializer(item);
+
+        notifyItemDataChanged(item, 1, {Qt::EditRole, Qt::DisplayRole, Qt::DecorationRole});
+
+        return;
+    }
+
+    for (const auto &entry : item->elementItems)
+        dropDestroyedObjectRows(entry.second.get());
+}
+
+void internal::PropertyGridTreeModel::releaseElements(PropertyGridTreeItem *item)
+{
+    // NOTE: the rows are announced again right away, only the items behind them get destroyed. removing them is what
+    //       makes the view drop any persistent indexes and editors that still point to these items
+    if (item->elementItems.empty())
+        return;
+
+    const QModelIndex index = getItemIndex(item);
+    const int count = item->elementsCount;
+
+    beginRemoveRows(index, 0, count - 1);
+    unregisterNestedItems(item);
+    item->elementItems.clear();
+    item->elementsCount = 0;
+    endRemoveRows();
+
+    beginInsertRows(index, 0, count - 1);
+    item->elementsCount = count;
+    endInsertRows();
+}
+
+void internal::PropertyGridTreeModel::unregisterNestedItems(const PropertyGridTreeItem *item)
+{
+    for (const auto &entry : item->elementItems)
+    {
+        unregisterNestedItems(entry.second.get());
+        m_nestedItemsMap.remove(&entry.second->context);
+    }
+}
+
+QModelIndex internal::PropertyGridTreeModel::getItemIndex(PropertyGridTreeItem *item) const
+{
+    if (item == m_rootItem)
+        return QModelIndex();
+
+    // NOTE: items that aren't shown get an invalid index
+    const int row = item->isElement() ? item->elementIndex : item->visibleRow;
+
+    return createIndex(row, 0, item);
+}
+
+void internal::PropertyGridTreeModel::clearModel()
+{
+    const TraceSpan span("PropertyGridTreeModel::clearModel");
+
+    beginResetModel();
+    {
+        m_categoriesMap.clear();
+        m_propertiesMap.clear();
+        m_pendingPropertiesMap.clear();
+        m_nestedItemsMap.clear();
+        m_filterIndex.clear();
+        m_sortKeys.clear();
+        m_propertyNames.clear();
+        m_modifiedProperties.clear();
+        m_rootItem->children.clear();
+        m_rootItem->visibleChildren.clear();
+    }
+    endResetModel();
+}
+
+quint64 internal::PropertyGridTreeModel::evictDisplayData(std::vector<PropertyGridTreeItem *> &&candidates, quint64 bytesCount)
+{
+    std::sort(candidates.begin(), candidates.end(),
+              [](const PropertyGridTreeItem *a, const PropertyGridTreeItem *b)
+              {
+                  //
+                  return a->lastAccess < b->lastAccess;
+              });
+
+    quint64 result = 0;
+
+    for (PropertyGridTreeItem *item : candidates)
+    {
+        if (result >= bytesCount)
+            break;
+
+        result += displayDataMemoryUsage(item);
+        item->evictDisplayData();
+    }
+
+    return result;
+}
+
+void internal::PropertyGridTreeModel::ensureDisplayData(PropertyGridTreeItem *item) const
+{
+    // NOTE: the loader sets the displayed text, which clears the flag
+    if (item->isDisplayDataEvicted && m_itemDataLoader)
+        m_itemDataLoader(item);
+}
+
+void internal::PropertyGridTreeModel::ensureDecoration(PropertyGridTreeItem *item) const
+{
+    // NOTE: the loader sets the decoration, which clears the flag
+    if (item->isDecorationPending && m_itemDecorationLoader)
+        m_itemDecorationLoader(item);
+}
+
+void internal::PropertyGridTreeModel::installTree(PropertyGridTreeSnapshot &&snapshot)
+{
+    beginResetModel();
+    {
+        delete m_rootItem;
+
+        m_rootItem = snapshot.rootItem.release();
+        m_propertiesMap = std::move(snapshot.propertiesMap);
+        m_categoriesMap = std::move(snapshot.categoriesMap);
+        m_pendingPropertiesMap.clear();
+        m_nestedItemsMap.clear();
+
+        m_filterIndex.clear();
+        m_sortKeys.clear();
+        m_propertyNames.clear();
+        m_modifiedProperties.clear();
+        for (PropertyGridTreeItem *categoryItem : m_categoriesMap)
+        {
+            for (const auto &child : categoryItem->children)
+            {
+                if (child->isTransient)
+                    continue;
+
+                child->propertyId = registerProperty(child->context, searchableText(child.get()));
+                watchValueObject(child.get());
+            }
+        }
+
+        rebuildVisibleRows();
+    }
+    endResetModel();
+}
+
+internal::PropertyGridCounters &internal::PropertyGridTreeModel::counters() const
+{
+    return m_counters;
+}
+
+void internal::PropertyGridTreeModel::update()
+{
+    const TraceSpan span("PropertyGridTreeModel::update");
+
+    beginResetModel();
+
+    rebuildVisibleRows();
+
+    // Notify about the structural change
+    emit layoutAboutToBeChanged();
+    emit dataChanged(createIndex(0, 0), createIndex(rowCount(), columnCount()));
+    emit layoutChanged();
+
+    endResetModel();
+}
+
+void internal::PropertyGridTreeModel::notifyItemDataChanged(PropertyGridTreeItem *item, int column, const QVector<int> &roles)
+{
+    const QModelIndex index = PM::internal::siblingAtColumn(getItemIndex(item), column);
+
+    if (!index.isValid())
+        return;
+
+    emit dataChanged(index, index, roles);
+}
+
+void internal::PropertyGridTreeModel::notifyItemsDataChanged(const std::vector<PropertyGridTreeItem *> &items, int column, const QVector<int> &roles)
+{
+    // NOTE: the ranges include the unchanged rows in between, repainting those is cheaper than a signal per row
+    QHash<QModelIndex, std::pair<int, int>> ranges;
+
+    for (PropertyGridTreeItem *item : items)
+    {
+        const QModelIndex index = getItemIndex(item);
+
+        if (!index.isValid())
+            continue;
+
+        auto it = ranges.find(index.parent());
+        if (it == ranges.end())
+            ranges.insert(index.parent(), {index.row(), index.row()});
+        else
+            *it = {std::min(it->first, index.row()), std::max(it->second, index.row())};
+    }
+
+    for (auto it = ranges.cbegin(); it != ranges.cend(); ++it)
+        emit dataChanged(index(it->first, column, it.key()), index(it->second, column, it.key()), roles);
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::getCategoryItem(const QString &category)
+{
+    PropertyGridTreeItem *result = m_categoriesMap.value(category);
+    if (result != nullptr)
+        return result;
+
+    // empty path components would become categories without a name
+    const QString path = categoryPath(category);
+    if (path != category)
+        return getCategoryItem(path);
+
+    // NOTE: a path that was seen before is a single lookup, only the missing prefixes of a new path get resolved
+    const int separatorIndex = category.lastIndexOf(QLatin1Char(categoryPathSeparator));
+    PropertyGridTreeItem *parentItem = separatorIndex < 0 ? m_rootItem : getCategoryItem(category.left(separatorIndex));
+
+    result = createCategoryItem(parentItem, category.mid(separatorIndex + 1), categoryFont(), categoryBackgroundColor());
+    result->childrenFetched = m_categoriesExpandedByDefault || !m_showCategories;
+
+    m_categoriesMap.insert(category, result);
+
+    return result;
+}
+
+QString internal::PropertyGridTreeModel::categoryName(const Property &property)
+{
+    if (property.hasAttribute<CategoryAttribute>())
+        return categoryPath(property.getAttribute<CategoryAttribute>().value);
+
+    return DEFAULT_CATEGORY_NAME;
+}
+
+QString internal::PropertyGridTreeModel::categoryPath(const QString &category)
+{
+    const QChar separator = QLatin1Char(categoryPathSeparator);
+
+    // NOTE: almost every path is fine as it is, those don't get copied
+    if (!category.isEmpty() && !category.startsWith(separator) && !category.endsWith(separator) && !category.contains(QString(2, separator)))
+        return category;
+
+    QString result;
+    result.reserve(category.size());
+
+    for (const QChar character : category)
+    {
+        if (character == separator && (result.isEmpty() || result.endsWith(separator)))
+            continue;
+
+        result.append(character);
+    }
+
+    if (result.endsWith(separator))
+        result.chop(1);
+
+    // a path made of separators only doesn't name any category
+    return result.isEmpty() ? QString(DEFAULT_CATEGORY_NAME) : result;
+}
+
+QFont internal::PropertyGridTreeModel::categoryFont()
+{
+    QFont result = QApplication::font(); // TODO: get font from parent PropertyGrid
+    result.setBold(true);
+
+    return result;
+}
+
+QFont internal::PropertyGridTreeModel::modifiedValueFont()
+{
+    // NOTE: only the weight is set, the view resolves everything else against its own font
+    static const QFont result = []()
+    {
+        QFont font;
+        font.setBold(true);
+
+        return font;
+    }();
+
+    return result;
+}
+
+QColor internal::PropertyGridTreeModel::categoryBackgroundColor()
+{
+    return QApplication::palette().color(QPalette::Inactive, QPalette::Window); // TODO: get palette from parent PropertyGrid
+}
+
+internal::PropertyGridTreeItem *internal::PropertyGridTreeModel::createCategoryItem(PropertyGridTreeItem *parent, const QString &category,
+                                                                                      const QFont &font, const QColor &backgroundColor)
+{
+    const PropertyContext tempCategoryContext = PropertyContextPrivate::createContext(PM::Property(category, QMetaType::UnknownType));
+    PropertyGridTreeItem *result = parent->addChild(tempCategoryContext);
+    result->isTransient = true;
+    // TODO: make category item expanded by default?!!
+
+    result->setColumnData(0, Qt::FontRole, font);
+    result->setColumnData(1, Qt::FontRole, font);
+    result->setColumnData(0, Qt::BackgroundRole, backgroundColor);
+    result->setColumnData(1, Qt::BackgroundRole, backgroundColor);
+
+    return result;
+}
+
+QVariant internal::PropertyGridTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    static QStringList headerNames = {"Name", "Value"};
+
+    if (section < 0 || section >= columnCount())
+        return QVariant();
+
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+        return headerNames[section];
+
+    return QVariant();
+}
+
+QModelIndex internal::PropertyGridTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0)
+        return QModelIndex();
+
+    PropertyGridTreeItem *parentItem = getItem(parent);
+    PropertyGridTreeItem *childItem = nullptr;
+
+    if (parentItem->elementsCount > 0)
+        childItem = getElementItem(parentItem, row);
+    else if (row >= 0 && row < int(parentItem->visibleChildren.size()))
+        childItem = parentItem->visibleChildren[row];
+
+    if (childItem != nullptr)
+        return createIndex(row, column, childItem);
+
+    return QModelIndex();
+}
+
+bool internal::PropertyGridTreeModel::insertRows(int position, int rows, const QModelIndex &parent)
+{
+    PropertyGridTreeItem *parentItem = getItem(parent);
+    if (!parentItem)
+        return false;
+
+    beginInsertRows(parent, position, position + rows - 1);
+    const bool result = parentItem->insertChildren(position, rows, columnCount());
+    endInsertRows();
+
+    return result;
+}
+
+QModelIndex internal::PropertyGridTreeModel::parent(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QModelIndex();
+
+    PropertyGridTreeItem *childItem = getItem(index);
+    PropertyGridTreeItem *parentItem = childItem->parent;
+
+    if (parentItem == m_rootItem || !parentItem)
+        return QModelIndex();
 
-    if (indexInParent < 0)
+    // properties are rows of the root when categories are flattened
+    if (!m_showCategories && parentItem->isTransient)
         return QModelIndex();
 
-    return createIndex(int(indexInParent), 0, parentItem);
+    return getItemIndex(parentItem);
 }
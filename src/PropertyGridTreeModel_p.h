@@ -11,18 +11,26 @@
 //
 //
 
-#include "PropertyEditor.h"
+#include "PropertyGrid.h"
+#include "PropertyGridFilterIndex_p.h"
+#include "PropertyGridIdSet_p.h"
+#include "PropertyGridStatistics_p.h"
 
 #include <QAbstractItemModel>
+#include <QCollator>
+#include <QColor>
+#include <QFont>
 #include <QModelIndex>
 
+#include <optional>
+
 namespace PM
 {
-class PropertyGrid;
-
 namespace internal
 {
     struct PropertyGridTreeItem;
+    struct CompositeTypePlan;
+    struct PropertyGridTreeSnapshot;
 
     class PropertyGridTreeModel : public QAbstractItemModel
     {
@@ -48,20 +56,78 @@ namespace internal
 
         Qt::ItemFlags flags(const QModelIndex &index) const override;
 
+        bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+        bool canFetchMore(const QModelIndex &parent) const override;
+        void fetchMore(const QModelIndex &parent) override;
+
         bool insertRows(int position, int rows, const QModelIndex &parent = QModelIndex()) override;
 
         bool showCategories() const;
         void setShowCategories(bool newShowCategories);
 
+        // when false, new categories only keep the descriptors of their properties until they get fetched
+        bool categoriesExpandedByDefault() const;
+        void setCategoriesExpandedByDefault(bool value);
+
         PropertyGridTreeItem *rootItem() const;
 
         bool isCategory(const QModelIndex &index) const;
 
         QModelIndex getCategory(const QString &category) const;
         PropertyGridTreeItem *getPropertyItem(const QString &propertyName) const;
+        PropertyContext *getPendingPropertyContext(const QString &propertyName) const;
+        const QHash<QString, PropertyGridTreeItem *> &propertyItems() const;
+        const QHash<QString, PropertyGridTreeItem *> &categoryItems() const; // by path, nested categories included
         [[deprecated]] PropertyGridTreeItem *getCategoryItem(const QString &category);
 
+        using ItemInitializer = std::function<void(PropertyGridTreeItem *item)>;
+
+        // gets called for every new property item before the view gets notified about it
+        void setItemInitializer(const ItemInitializer &initializer);
+        // same for element items, which get created from index(). the displayed data is left to the data loader
+        void setElementItemInitializer(const ItemInitializer &initializer);
+        // generates the displayed text and the decoration of items whose caches got evicted, see evictDisplayData()
+        void setItemDataLoader(const ItemInitializer &loader);
+        // generates the decoration of items that got built without one, see PropertyGridTreeItem::isDecorationPending
+        void setItemDecorationLoader(const ItemInitializer &loader);
+
         QModelIndex addProperty(const PropertyContext &context);
+        // inserts the properties using one contiguous range of rows per category
+        void addProperties(const std::vector<PropertyContext> &contexts);
+
+        void fetchCategory(PropertyGridTreeItem *categoryItem);
+
+        // only the properties whose name, description or displayed value contain the filter text are shown
+        QString filterText() const;
+        void setFilterText(const QString &text);
+        // re-filters and re-sorts a property after its value (and so its displayed text) has changed
+        void refreshPropertyRow(PropertyGridTreeItem *item);
+        // the same for many properties at once, their rows get moved around by a single layout change at most
+        void refreshPropertyRows(const std::vector<PropertyGridTreeItem *> &items);
+        // picks up the new value of a property that doesn't have an item yet, see getPendingPropertyContext()
+        void refreshPendingProperty(const QString &propertyName);
+        // hidden properties stay hidden whatever the filter is
+        void setItemHidden(PropertyGridTreeItem *item, bool hidden);
+
+        // properties with a DefaultValueAttribute are modified while they hold another value, their values are shown in bold.
+        // the states are kept up to date by refreshPropertyRow() and refreshPendingProperty()
+        int modifiedPropertiesCount() const;
+        void forEachModifiedProperty(const std::function<void(const QString &propertyName)> &function) const;
+
+        // sorting only reorders the visible rows, the items themselves are never touched
+        PropertyGrid::SortMode sortMode() const;
+        void setSortMode(PropertyGrid::SortMode mode);
+
+        // elements of containers are virtual rows, getElementItem() creates their items the first time they are accessed
+        PropertyGridTreeItem *getElementItem(PropertyGridTreeItem *containerItem, int index) const;
+        PropertyGridTreeItem *getNestedItem(const PropertyContext &context) const;
+        // synchronizes the element rows with a container value that got replaced as a whole
+        void updateElements(PropertyGridTreeItem *containerItem);
+        // destroys the element items below the given item, they get created again the next time they are accessed
+        void releaseElements(PropertyGridTreeItem *item);
+
+        // replaces the whole tree with a detached one in a single model reset
+        void installTree(PropertyGridTreeSnapshot &&snapshot);
 
         PropertyGridTreeItem *getItem(const QModelIndex &index) const; // FIXME: should this be public?!!
         QModelIndex getItemIndex(PropertyGridTreeItem *item) const;
@@ -69,21 +135,135 @@ namespace internal
         void clearModel();
         QStringList getPropertiesNames() const;
 
+        // evicts the cached texts and decorations of the given items until `bytesCount` got freed, least recently used first
+        quint64 evictDisplayData(std::vector<PropertyGridTreeItem *> &&candidates, quint64 bytesCount);
+        void ensureDisplayData(PropertyGridTreeItem *item) const;
+        void ensureDecoration(PropertyGridTreeItem *item) const;
+
+        // counts the work of the model as well as of the grid around it, see PropertyGrid::statistics()
+        PropertyGridCounters &counters() const;
+
         void update();
+        void notifyItemDataChanged(PropertyGridTreeItem *item, int column, const QVector<int> &roles = QVector<int>());
+        // a single dataChanged() per parent, spanning the rows of all the given items below it
+        void notifyItemsDataChanged(const std::vector<PropertyGridTreeItem *> &items, int column, const QVector<int> &roles = QVector<int>());
+
+        // nested categories are given as paths, e.g. "Rendering/Shadows/Cascades"
+        static constexpr char categoryPathSeparator = '/';
+
+        static QString categoryName(const Property &property);
+        // drops the leading, trailing and repeated separators, e.g. "/Rendering//Shadows/" is "Rendering/Shadows"
+        static QString categoryPath(const QString &category);
+        static QFont categoryFont();
+        static QFont modifiedValueFont();
+        static QColor categoryBackgroundColor();
+        static PropertyGridTreeItem *createCategoryItem(PropertyGridTreeItem *parent, const QString &category, const QFont &font,
+                                                        const QColor &backgroundColor);
+
+    private:
+        void insertPropertiesIntoCategory(const QString &category, const std::vector<const PropertyContext *> &contexts);
+        // pending properties already got their id when they were added
+        PropertyGridTreeItem *createPropertyItem(PropertyGridTreeItem *categoryItem, const PropertyContext &context, int propertyId = -1);
+        int registerProperty(const PropertyContext &context, const QString &searchableText);
+        bool updateModifiedState(int propertyId, const PropertyContext &context);
+        void unregisterNestedItems(const PropertyGridTreeItem *item);
+        void updateElementRows(PropertyGridTreeItem *containerItem);
+
+        // the sub-rows of objects that get deleted are dropped, see PropertyGridTreeItem::trackValueObject()
+        void watchValueObject(const PropertyGridTreeItem *item) const;
+        void scheduleDestroyedObjectsCleanup();
+        void dropDestroyedObjectRows(PropertyGridTreeItem *item);
+
+        QString searchableText(PropertyGridTreeItem *item) const;
+        static QString searchableText(const Property &property, const QString &value);
+        bool isItemAccepted(const PropertyGridTreeItem *item) const;
+        bool isItemShown(const PropertyGridTreeItem *item) const;
+        bool isCategoryAccepted(const PropertyGridTreeItem *categoryItem) const;
+        // categories that weren't fetched yet are shown as long as any of their pending properties matches the filter
+        bool isPendingCategoryAccepted(const PropertyGridTreeItem *categoryItem) const;
+
+        // the rows the view sees are the visibleChildren of the items, see rebuildVisibleRows()
+        void rebuildVisibleRows();
+        void rebuildVisibleRows(PropertyGridTreeItem *categoryItem);
+        void relayoutVisibleRows();
+        void changePersistentRows(const QModelIndexList &oldIndexes);
+        // only the categories of the properties whose filter match changed get their rows updated, in a single layout change
+        void applyFilterChanges(const std::vector<int> &changedIds);
+        void updateFilteredRows(PropertyGridTreeItem *categoryItem, std::vector<PropertyGridTreeItem *> &enteredItems);
+        void updateFlatFilteredRows(std::vector<PropertyGridTreeItem *> &enteredItems);
+        void appendFlatRows(const PropertyGridTreeItem *parentItem, std::vector<PropertyGridTreeItem *> &rows) const;
+        void updateVisibleRows(PropertyGridTreeItem *parentItem, int first);
+        int visibleInsertPosition(const PropertyGridTreeItem *parentItem, const PropertyGridTreeItem *item) const;
+        int flatRowPosition(const PropertyGridTreeItem *categoryItem) const;
+        bool flatRowPosition(const PropertyGridTreeItem *parentItem, const PropertyGridTreeItem *categoryItem, int &result) const;
+        void insertVisibleRows(PropertyGridTreeItem *categoryItem, const std::vector<PropertyGridTreeItem *> &items);
+        void showCategoryRow(PropertyGridTreeItem *categoryItem);
+        void showPropertyRow(PropertyGridTreeItem *item);
+        void hidePropertyRow(PropertyGridTreeItem *item);
+        void hideVisibleRow(PropertyGridTreeItem *item);
+        bool updatePropertyRowVisibility(PropertyGridTreeItem *item);
+
+        struct PropertySortKey
+        {
+            QCollatorSortKey name;
+            QCollatorSortKey value; // of the displayed text
+            double number;
+            bool isNumber;
+        };
+
+        // moves a single row to its sorted position, the other rows of its parent are expected to be sorted already
+        void sortVisibleRow(PropertyGridTreeItem *item);
+        // the same for a category that just got shown, along with the ancestors that got shown with it
+        void sortCategoryRow(PropertyGridTreeItem *categoryItem);
+        // sorts the rows of a single parent, the view only gets notified about a layout change of that parent
+        void sortVisibleRows(PropertyGridTreeItem *parentItem);
+        // places rows that were just inserted at their unsorted position
+        void sortInsertedRows(PropertyGridTreeItem *categoryItem, const std::vector<PropertyGridTreeItem *> &items);
+        void sortRows(std::vector<PropertyGridTreeItem *> &rows) const;
+        // sorts the other rows on their own and merges them into the already sorted rows
+        void mergeRows(std::vector<PropertyGridTreeItem *> &rows, std::vector<PropertyGridTreeItem *> &otherRows) const;
+        bool isSortedAt(const PropertyGridTreeItem *item) const;
+        bool lessThan(const PropertyGridTreeItem *a, const PropertyGridTreeItem *b) const;
+        const PropertySortKey &sortKey(const PropertyGridTreeItem *item) const;
+
+        struct PendingPropertyLocation
+        {
+            PropertyGridTreeItem *categoryItem;
+            size_t index;
+            int propertyId;
+        };
 
     private:
         bool m_showCategories;
+        bool m_categoriesExpandedByDefault;
+        PropertyGrid::SortMode m_sortMode;
         PropertyGridTreeItem *m_rootItem;
+        ItemInitializer m_itemInitializer;
+        ItemInitializer m_elementItemInitializer;
+        ItemInitializer m_itemDataLoader;
+        ItemInitializer m_itemDecorationLoader;
+        mutable quint64 m_accessClock; // ticks on every data() call, see PropertyGridTreeItem::lastAccess
+        bool m_isDestroyedObjectsCleanupScheduled;
 
         QHash<QString, PropertyGridTreeItem *> m_propertiesMap;
         QHash<QString, PropertyGridTreeItem *> m_categoriesMap;
+        QHash<QString, PendingPropertyLocation> m_pendingPropertiesMap;
+        mutable QHash<const PropertyContext *, PropertyGridTreeItem *> m_nestedItemsMap; // items that aren't properties on their own
+
+        PropertyGridFilterIndex m_filterIndex; // indexed by PropertyGridTreeItem::propertyId
+        QCollator m_collator;
+        mutable std::vector<std::optional<PropertySortKey>> m_sortKeys; // indexed by PropertyGridTreeItem::propertyId
+        std::vector<QString> m_propertyNames;                            // indexed by PropertyGridTreeItem::propertyId
+        PropertyGridIdSet m_modifiedProperties;
+
+        mutable PropertyGridCounters m_counters;
     };
 } // namespace internal
 } // namespace PM
 
 inline QStringList PM::internal::PropertyGridTreeModel::getPropertiesNames() const
 {
-    return m_propertiesMap.keys();
+    return m_propertiesMap.keys() + m_pendingPropertiesMap.keys();
 }
 
 #endif // PROPERTYGRIDTREEMODEL_P_H
@@ -0,0 +1,280 @@
+#include "PropertyGridValues_p.h"
+
+#include "QtCompat_p.h"
+
+#include <QIODevice>
+
+#include <algorithm>
+
+namespace
+{
+// the first line of the text format, the version follows the prefix
+const char VALUES_TEXT_HEADER_PREFIX[] = "# PM::PropertyGrid values ";
+const int VALUES_TEXT_VERSION = 1;
+
+const quint32 VALUES_BINARY_MAGIC = 0x504d4756; // "PMGV"
+const quint16 VALUES_BINARY_VERSION = 1;
+
+// the oldest stream format that both Qt5 and Qt6 read and write
+const QDataStream::Version VALUES_BINARY_STREAM_VERSION = QDataStream::Qt_5_9;
+
+// the text format gets handed to the device in chunks of this size
+const int VALUES_TEXT_CHUNK_SIZE = 64 * 1024;
+} // namespace
+
+using namespace PM;
+
+internal::PropertyValuesWriter::PropertyValuesWriter(QIODevice *device, PropertyGrid::ValuesFormat format) :
+    m_device(device),
+    m_format(format),
+    m_hasError(false)
+{
+    if (m_format == PropertyGrid::ValuesFormat::Binary)
+    {
+        m_stream.setDevice(device);
+        m_stream.setVersion(VALUES_BINARY_STREAM_VERSION);
+        m_stream << VALUES_BINARY_MAGIC << VALUES_BINARY_VERSION;
+
+        return;
+    }
+
+    // NOTE: a reserved buffer keeps its capacity when it gets emptied, see flush()
+    m_buffer.reserve(VALUES_TEXT_CHUNK_SIZE + 1024);
+    m_buffer.append(VALUES_TEXT_HEADER_PREFIX).append(QByteArray::number(VALUES_TEXT_VERSION)).append('\n');
+}
+
+void internal::PropertyValuesWriter::writeText(const QString &name, const QString &text)
+{
+    appendEscaped(name);
+    m_buffer.append('\t');
+    appendEscaped(text);
+    m_buffer.append('\n');
+
+    if (m_buffer.size() >= VALUES_TEXT_CHUNK_SIZE)
+        flush();
+}
+
+bool internal::PropertyValuesWriter::writeValue(const QString &name, const QVariant &value)
+{
+    // NOTE: a value without stream operators would leave a record behind that can't be read back
+    if (value.isValid() && !internal::hasDataStreamOperators(internal::getVariantTypeId(value)))
+        return false;
+
+    m_stream << name << value;
+
+    return true;
+}
+
+bool internal::PropertyValuesWriter::finish(QString *errorMessage)
+{
+    if (m_format == PropertyGrid::ValuesFormat::Text)
+        flush();
+    else
+        m_hasError = m_stream.status() != QDataStream::Ok;
+
+    if (m_hasError && errorMessage != nullptr)
+        *errorMessage = m_device->errorString();
+
+    return !m_hasError;
+}
+
+void internal::PropertyValuesWriter::appendEscaped(const QString &text)
+{
+    // NOTE: the bytes of multibyte UTF-8 sequences are never ASCII, escaping them one byte at a time is safe
+    const QByteArray bytes = text.toUtf8();
+
+    const char *runStart = bytes.constData();
+    const char *end = runStart + bytes.size();
+
+    for (const char *it = runStart; it != end; ++it)
+    {
+        const char *escape = nullptr;
+
+        switch (*it)
+        {
+        case '\\':
+            escape = "\\\\";
+            break;
+        case '\t':
+            escape = "\\t";
+            break;
+        case '\n':
+            escape = "\\n";
+            break;
+        case '\r':
+            escape = "\\r";
+            break;
+        default:
+            continue;
+        }
+
+        m_buffer.append(runStart, int(it - runStart)).append(escape);
+        runStart = it + 1;
+    }
+
+    m_buffer.append(runStart, int(end - runStart));
+}
+
+void internal::PropertyValuesWriter::flush()
+{
+    if (!m_hasError && m_device->write(m_buffer) != m_buffer.size())
+        m_hasError = true;
+
+    m_buffer.resize(0);
+}
+
+internal::PropertyValuesReader::PropertyValuesReader(QIODevice *device, PropertyGrid::ValuesFormat format) :
+    m_device(device),
+    m_format(format),
+    m_isHeaderRead(false),
+    m_lineNumber(0)
+{
+    if (m_format != PropertyGrid::ValuesFormat::Binary)
+        return;
+
+    m_stream.setDevice(device);
+    m_stream.setVersion(VALUES_BINARY_STREAM_VERSION);
+}
+
+bool internal::PropertyValuesReader::readNext(QString &name, QString &text, QVariant &value)
+{
+    if (hasError())
+        return false;
+
+    if (!m_isHeaderRead)
+    {
+        if (!readHeader())
+            return false;
+
+        m_isHeaderRead = true;
+    }
+
+    if (m_format == PropertyGrid::ValuesFormat::Text)
+        return readNextLine(name, text);
+
+    if (m_stream.atEnd())
+        return false;
+
+    m_stream >> name >> value;
+
+    if (m_stream.status() != QDataStream::Ok)
+        return fail("truncated or corrupt value record");
+
+    return true;
+}
+
+bool internal::PropertyValuesReader::hasError() const
+{
+    return !m_errorString.isEmpty();
+}
+
+QString internal::PropertyValuesReader::errorString() const
+{
+    return m_errorString;
+}
+
+bool internal::PropertyValuesReader::readHeader()
+{
+    if (m_format == PropertyGrid::ValuesFormat::Binary)
+    {
+        quint32 magic = 0;
+        quint16 version = 0;
+        m_stream >> magic >> version;
+
+        if (m_stream.status() != QDataStream::Ok || magic != VALUES_BINARY_MAGIC)
+            return fail("not a property values file");
+
+        if (version != VALUES_BINARY_VERSION)
+            return fail(QString("unsupported property values version %1").arg(version));
+
+        return true;
+    }
+
+    const QByteArray header = m_device->readLine().trimmed();
+    ++m_lineNumber;
+
+    if (!header.startsWith(VALUES_TEXT_HEADER_PREFIX))
+        return fail("not a property values file");
+
+    const QByteArray version = header.mid(int(sizeof(VALUES_TEXT_HEADER_PREFIX)) - 1);
+    if (version.toInt() != VALUES_TEXT_VERSION)
+        return fail(QString("unsupported property values version %1").arg(QString::fromLatin1(version)));
+
+    return true;
+}
+
+bool internal::PropertyValuesReader::readNextLine(QString &name, QString &text)
+{
+    while (true)
+    {
+        const QByteArray line = m_device->readLine();
+        if (line.isEmpty())
+            return false;
+
+        ++m_lineNumber;
+
+        // line breaks within the values are escaped, a trailing carriage return comes from an editor
+        const char *begin = line.constData();
+        const char *end = begin + line.size();
+
+        if (end[-1] == '\n')
+            --end;
+        if (end != begin && end[-1] == '\r')
+            --end;
+
+        if (begin == end)
+            continue;
+
+        const char *separator = std::find(begin, end, '\t');
+        if (separator == end)
+            return fail(QString("line %1: the name isn't followed by a tab and a value").arg(m_lineNumber));
+
+        name = unescaped(begin, separator);
+        text = unescaped(separator + 1, end);
+
+        return true;
+    }
+}
+
+bool internal::PropertyValuesReader::fail(const QString &message)
+{
+    m_errorString = message;
+
+    return false;
+}
+
+QString internal::PropertyValuesReader::unescaped(const char *begin, const char *end)
+{
+    if (std::find(begin, end, '\\') == end)
+        return QString::fromUtf8(begin, int(end - begin));
+
+    QByteArray result;
+    result.reserve(int(end - begin));
+
+    for (const char *it = begin; it != end; ++it)
+    {
+        if (*it != '\\' || it + 1 == end)
+        {
+            result.append(*it);
+            continue;
+        }
+
+        switch (*++it)
+        {
+        case 't':
+            result.append('\t');
+            break;
+        case 'n':
+            result.append('\n');
+            break;
+        case 'r':
+            result.append('\r');
+            break;
+        default: // backslashes, as well as sequences this version doesn't know of, are taken as they are
+            result.append(*it);
+            break;
+        }
+    }
+
+    return QString::fromUtf8(result);
+}
@@ -0,0 +1,85 @@
+#ifndef PROPERTYGRIDVALUES_P_H
+#define PROPERTYGRIDVALUES_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the PM::PropertyGrid API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+//
+
+#include "PropertyGrid.h"
+
+#include <QDataStream>
+
+namespace PM
+{
+namespace internal
+{
+    // writes the name/value records of PropertyGrid::exportValues(), the text format gets written in large chunks
+    class PropertyValuesWriter
+    {
+    public:
+        PropertyValuesWriter(QIODevice *device, PropertyGrid::ValuesFormat format);
+
+        PropertyValuesWriter(const PropertyValuesWriter &) = delete;
+        PropertyValuesWriter &operator=(const PropertyValuesWriter &) = delete;
+
+        void writeText(const QString &name, const QString &text);   // Text format only
+        bool writeValue(const QString &name, const QVariant &value); // Binary format only, false when the value can't be serialized
+
+        // writes out what's left in the buffer
+        bool finish(QString *errorMessage);
+
+    private:
+        void appendEscaped(const QString &text);
+        void flush();
+
+    private:
+        QIODevice *m_device;
+        PropertyGrid::ValuesFormat m_format;
+
+        QByteArray m_buffer;
+        QDataStream m_stream;
+        bool m_hasError;
+    };
+
+    // reads back what PropertyValuesWriter wrote, one record at a time
+    class PropertyValuesReader
+    {
+    public:
+        PropertyValuesReader(QIODevice *device, PropertyGrid::ValuesFormat format);
+
+        PropertyValuesReader(const PropertyValuesReader &) = delete;
+        PropertyValuesReader &operator=(const PropertyValuesReader &) = delete;
+
+        // false at the end of the data or on errors, see hasError(). Only one of `text` and `value` gets filled in,
+        // depending on the format
+        bool readNext(QString &name, QString &text, QVariant &value);
+
+        bool hasError() const;
+        QString errorString() const;
+
+    private:
+        bool readHeader();
+        bool readNextLine(QString &name, QString &text);
+        bool fail(const QString &message);
+
+        static QString unescaped(const char *begin, const char *end);
+
+    private:
+        QIODevice *m_device;
+        PropertyGrid::ValuesFormat m_format;
+
+        QDataStream m_stream;
+        bool m_isHeaderRead;
+        int m_lineNumber;
+        QString m_errorString;
+    };
+} // namespace internal
+} // namespace PM
+
+#endif // PROPERTYGRIDVALUES_P_H
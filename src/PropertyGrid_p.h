@@ -14,12 +14,17 @@
 #include "PropertyGrid.h"
 #include "ui_PropertyGrid.h"
 
+#include "PropertyGridDependencyGraph_p.h"
+#include "PropertyGridSession.h"
+#include "PropertyGridTreeBuilder_p.h"
 #include "PropertyGridTreeModel_p.h"
 
 #include <QComboBox>
+#include <QPointer>
 #include <QLineEdit>
 #include <QProxyStyle>
 #include <QStyledItemDelegate>
+#include <QTimer>
 #include <QToolButton>
 #include <QVBoxLayout>
 
@@ -41,6 +46,9 @@ namespace internal
         QWidget *dropDownWidget() const;
         void setDropDownWidget(QWidget *value);
 
+        // shows the model as it is, along with a completer that narrows the items down while typing
+        void setListModel(DropDownListModel *model);
+
     protected:
         void showPopup() override;
         void hidePopup() override;
@@ -94,11 +102,13 @@ namespace internal
     private slots:
         void onUiValueChanged();
         void onTextEditingFinished();
+        void onModalButtonClicked();
         void onDropDownComboBoxCurrentIndexChanged(int index);
 
     private:
         void setEditStyle();
         void initializeWidgetData();
+        void setDropDownModel(DropDownListModel *model);
 
         QString text() const;
         void setText(const QString &value);
@@ -106,6 +116,7 @@ namespace internal
         QString valueToString(const QVariant &value) const;
 
         PropertyEditor::EditStyle editStyle() const;
+        PropertyGridCounters::EditorCounters *editorCounters(const PropertyEditor &editor) const; // nullptr once the property grid is gone
 
     private:
         QVariant m_uiValue;
@@ -119,6 +130,7 @@ namespace internal
         PropertyContext *m_context;
 
         PropertyEditorComboBox m_dropDownComboBox;
+        QToolButton m_dropDownModalButton; // for the DropDownWithModal edit style
         PropertyEditorLineEdit m_propertylineEdit;
     };
 
@@ -175,12 +187,54 @@ public:
 
     void closeEditor();
     void updatePropertyValue(const QModelIndex &index, const QVariant &value);
+    void updateElementValue(internal::PropertyGridTreeItem *item, const QVariant &value);
+
+    void expandCategories();
+    void initializePropertyItem(internal::PropertyGridTreeItem *item) const;
+    void initializeElementItem(internal::PropertyGridTreeItem *item) const;
+    void setReadOnlyStyle(internal::PropertyGridTreeItem *item) const;
+    void updateItemData(internal::PropertyGridTreeItem *item) const;
+
+    void populateNextSlice();
+    void finishPopulation(bool cancelled);
+
+    PropertyGridMemoryUsage memoryUsage() const;
+    void scheduleMemoryBudgetCheck();
+    void enforceMemoryBudget();
 
     bool setPropertyValue(const PropertyContext &context, const QVariant &value);
+    bool setPendingPropertyValue(const QString &propertyName, const QVariant &value);
+    void recordEdit(const PropertyContext &context);
+
+    bool exportValues(QIODevice *device, PropertyGrid::ValuesFormat format, PropertyGrid::ValuesExportMode mode, QString *errorMessage) const;
+    bool importValues(QIODevice *device, PropertyGrid::ValuesFormat format, QString *errorMessage);
+    // sets the values of many properties with a single notification of the view per parent, pending properties included
+    void applyValues(const std::vector<std::pair<PropertyContext *, QVariant>> &values);
+    void resetToDefaultValues(const QStringList &propertyNames);
     // TODO: maybe change this to return a const reference?!!
     PropertyEditor *getEditorForProperty(const PropertyContext &context) const;
+    // the statistics counters of the editor, resolved once per editor, see PropertyGridCounters::editorCounters()
+    internal::PropertyGridCounters::EditorCounters *editorCounters(const PropertyEditor &editor) const;
+
+    static QPixmap previewIcon(const PropertyEditor &editor, const PropertyContext &context);
+    QPixmap generateDecoration(const QPixmap &pixmap) const;
+
+    internal::PropertyGridTreeBuilder createTreeBuilder() const;
+    void installLoadedTree();
+    void loadItemDecoration(internal::PropertyGridTreeItem *item) const;
+
+    PropertyContext *findPropertyContext(const QString &propertyName) const;
+    void addComputedProperty(const PropertyContext &context);
+    void updateComputedProperties(const QString &propertyName, bool includeSelf = false);
+    bool recomputeProperty(const QString &propertyName);
+    void updateComputedState(internal::PropertyGridTreeItem *item);
 
-    static QPixmap generateDecoration(const QPixmap &pixmap);
+    // the states of the computed properties, see DependsOnAttribute
+    struct ComputedState
+    {
+        bool isReadOnly = false;
+        bool isVisible = true;
+    };
 
 public: // slots
     void handleUiSelectionChange(const QModelIndex &current, const QModelIndex &previous);
@@ -194,6 +248,25 @@ public:
 
     internal::PropertyGridTreeModel m_model;
     internal::PropertyEditorsMap_t m_propertyEditors;
+    mutable QHash<const PropertyEditor *, internal::PropertyGridCounters::EditorCounters *> m_editorCounters; // by editor
+
+    internal::PropertyGridTreeLoader m_treeLoader;
+
+    QTimer m_populationTimer;
+    // null once the population finished. a slice that is running holds on to the generator, so that the handlers it
+    // calls into (the generator itself included) can cancel or restart the population without destroying it under it
+    std::shared_ptr<PropertyGenerator> m_populationGenerator;
+    int m_populationTimeBudget;
+    int m_populatedCount;
+
+    internal::PropertyGridDependencyGraph m_dependencyGraph;
+    QHash<QString, ComputedState> m_computedStates;
+    bool m_isUpdatingComputedProperties;
+
+    QPointer<PropertyGridRecorder> m_recorder; // see PropertyGridRecorder
+
+    quint64 m_memoryBudget;
+    QTimer m_memoryBudgetTimer; // measuring walks the whole tree, the checks are coalesced
 };
 } // namespace PM
 
@@ -0,0 +1,441 @@
+#include "PropertySchemaFile.h"
+
+#include "QtCompat_p.h"
+
+#include <QDataStream>
+#include <QHash>
+#include <QIODevice>
+#include <QtEndian>
+
+#include <limits>
+
+namespace
+{
+//
+// Layout, all integers are little-endian quint32 unless stated otherwise and the offsets are from the start of the file:
+//
+//   header:       magic, version (quint16), reserved (quint16), properties count, strings count,
+//                 properties offset, string table offset, values offset, values size
+//   properties:   name, type name, category and description as string indexes (NO_STRING when missing),
+//                 default value offset and size in the values (size 0 when missing), flags
+//   string table: offset and length (in UTF-16 code units) of every string
+//   strings:      UTF-16 little-endian, each one aligned to 4 bytes
+//   values:       the default values, each one serialized as a QVariant with QDataStream
+//
+const quint32 SCHEMA_FILE_MAGIC = 0x53504d50; // "PMPS"
+const quint16 SCHEMA_FILE_VERSION = 1;
+
+const quint32 SCHEMA_HEADER_SIZE = 32;
+const quint32 SCHEMA_RECORD_SIZE = 28;
+const quint32 SCHEMA_STRING_ENTRY_SIZE = 8;
+
+const quint32 NO_STRING = 0xffffffff;
+
+// the oldest stream format that both Qt5 and Qt6 read and write
+const QDataStream::Version SCHEMA_VALUES_STREAM_VERSION = QDataStream::Qt_5_9;
+
+enum RecordField
+{
+    NameField,
+    TypeField,
+    CategoryField,
+    DescriptionField,
+    DefaultValueOffsetField,
+    DefaultValueSizeField,
+    FlagsField,
+};
+
+enum RecordFlag : quint32
+{
+    HasReadOnlyFlag = 0x01,
+    ReadOnlyFlag = 0x02,
+};
+
+// the type names are resolved to ids on first use
+const int UNRESOLVED_TYPE = -1;
+
+quint32 readUInt32(const uchar *data, quint32 field = 0)
+{
+    return qFromLittleEndian<quint32>(data + field * sizeof(quint32));
+}
+
+void appendUInt32(QByteArray &data, quint32 value)
+{
+    uchar bytes[sizeof(quint32)];
+    qToLittleEndian(value, bytes);
+
+    data.append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+void alignTo4(QByteArray &data)
+{
+    while (data.size() % 4 != 0)
+        data.append('\0');
+}
+
+bool fail(const QString &message, QString *errorMessage)
+{
+    if (errorMessage != nullptr)
+        *errorMessage = message;
+
+    return false;
+}
+} // namespace
+
+using namespace PM;
+
+bool PropertySchemaFile::compile(const std::vector<Property> &properties, QIODevice *device, QString *errorMessage)
+{
+    std::vector<QString> strings;
+    QHash<QString, quint32> stringIndexes;
+
+    const auto intern = [&strings, &stringIndexes](const QString &string)
+    {
+        const auto it = stringIndexes.constFind(string);
+        if (it != stringIndexes.constEnd())
+            return it.value();
+
+        const quint32 result = quint32(strings.size());
+        strings.push_back(string);
+        stringIndexes.insert(string, result);
+
+        return result;
+    };
+
+    QByteArray records;
+    QByteArray values;
+
+    QDataStream valuesStream(&values, QIODevice::WriteOnly);
+    valuesStream.setVersion(SCHEMA_VALUES_STREAM_VERSION);
+
+    for (const Property &property : properties)
+    {
+        const bool hasCategory = property.hasAttribute<CategoryAttribute>();
+        const bool hasDescription = property.hasAttribute<DescriptionAttribute>();
+
+        appendUInt32(records, intern(property.name()));
+        appendUInt32(records, intern(internal::getMetaTypeName(property.type())));
+        appendUInt32(records, hasCategory ? intern(property.getAttribute<CategoryAttribute>().value) : NO_STRING);
+        appendUInt32(records, hasDescription ? intern(property.getAttribute<DescriptionAttribute>().value) : NO_STRING);
+
+        if (property.hasAttribute<DefaultValueAttribute>())
+        {
+            const QVariant defaultValue = property.getAttribute<DefaultValueAttribute>().value;
+
+            if (!internal::hasDataStreamOperators(internal::getVariantTypeId(defaultValue)))
+                return fail(QString("the default value of property \"%1\" can't be serialized").arg(property.name()), errorMessage);
+
+            const int offset = values.size();
+            valuesStream << defaultValue;
+
+            appendUInt32(records, quint32(offset));
+            appendUInt32(records, quint32(values.size() - offset));
+        }
+        else
+        {
+            appendUInt32(records, 0);
+            appendUInt32(records, 0);
+        }
+
+        quint32 flags = 0;
+        if (property.hasAttribute<ReadOnlyAttribute>())
+            flags |= HasReadOnlyFlag | (property.getAttribute<ReadOnlyAttribute>().value ? ReadOnlyFlag : 0);
+
+        appendUInt32(records, flags);
+    }
+
+    // the strings follow their table, the offsets in the table are only known once the strings are laid out
+    const quint32 propertiesOffset = SCHEMA_HEADER_SIZE;
+    const quint32 stringTableOffset = propertiesOffset + quint32(records.size());
+    const quint32 stringsOffset = stringTableOffset + quint32(strings.size()) * SCHEMA_STRING_ENTRY_SIZE;
+
+    QByteArray stringTable;
+    QByteArray stringsData;
+
+    for (const QString &string : strings)
+    {
+        appendUInt32(stringTable, stringsOffset + quint32(stringsData.size()));
+        appendUInt32(stringTable, quint32(string.size()));
+
+        for (const QChar c : string)
+        {
+            uchar bytes[sizeof(quint16)];
+            qToLittleEndian(quint16(c.unicode()), bytes);
+            stringsData.append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+        }
+
+        alignTo4(stringsData);
+    }
+
+    const quint32 valuesOffset = stringsOffset + quint32(stringsData.size());
+
+    QByteArray header;
+    appendUInt32(header, SCHEMA_FILE_MAGIC);
+    appendUInt32(header, SCHEMA_FILE_VERSION); // along with the reserved 16 bits
+    appendUInt32(header, quint32(properties.size()));
+    appendUInt32(header, quint32(strings.size()));
+    appendUInt32(header, propertiesOffset);
+    appendUInt32(header, stringTableOffset);
+    appendUInt32(header, valuesOffset);
+    appendUInt32(header, quint32(values.size()));
+
+    for (const QByteArray *part : {&header, &records, &stringTable, &stringsData, &values})
+    {
+        if (device->write(*part) != part->size())
+            return fail(device->errorString(), errorMessage);
+    }
+
+    return true;
+}
+
+PropertySchemaFile::PropertySchemaFile() :
+    m_data(nullptr),
+    m_size(0),
+    m_count(0),
+    m_stringsCount(0),
+    m_propertiesOffset(0),
+    m_stringTableOffset(0),
+    m_valuesOffset(0),
+    m_nextIndex(0)
+{
+}
+
+PropertySchemaFile::~PropertySchemaFile()
+{
+    close();
+}
+
+bool PropertySchemaFile::open(const QString &fileName, QString *errorMessage)
+{
+    close();
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    // NOTE: the strings are served from the mapping as they are, they have to be in the byte order of the machine
+    Q_UNUSED(fileName)
+    return fail("compiled schemas can only be opened on little-endian machines", errorMessage);
+#else
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(m_file.errorString(), errorMessage);
+
+    m_size = m_file.size();
+    m_data = m_size >= SCHEMA_HEADER_SIZE ? m_file.map(0, m_size) : nullptr;
+
+    const auto invalid = [this, errorMessage](const QString &message)
+    {
+        close();
+
+        return fail(message, errorMessage);
+    };
+
+    if (m_data == nullptr || readUInt32(m_data) != SCHEMA_FILE_MAGIC)
+        return invalid("not a compiled property schema");
+
+    if ((readUInt32(m_data, 1) & 0xffff) > SCHEMA_FILE_VERSION)
+        return invalid(QString("unsupported schema version %1").arg(readUInt32(m_data, 1) & 0xffff));
+
+    const quint64 count = readUInt32(m_data, 2);
+    m_stringsCount = readUInt32(m_data, 3);
+    m_propertiesOffset = readUInt32(m_data, 4);
+    m_stringTableOffset = readUInt32(m_data, 5);
+    m_valuesOffset = readUInt32(m_data, 6);
+    const quint64 valuesSize = readUInt32(m_data, 7);
+
+    // NOTE: 64 bits so that corrupt counts and offsets can't overflow
+    const quint64 size = quint64(m_size);
+
+    if (count > quint64(std::numeric_limits<int>::max()) || m_propertiesOffset % 4 != 0 || m_stringTableOffset % 4 != 0 ||
+        m_propertiesOffset + count * SCHEMA_RECORD_SIZE > size || m_stringTableOffset + quint64(m_stringsCount) * SCHEMA_STRING_ENTRY_SIZE > size ||
+        m_valuesOffset + valuesSize > size)
+        return invalid("truncated schema tables");
+
+    for (quint32 i = 0; i < m_stringsCount; ++i)
+    {
+        const uchar *entry = m_data + m_stringTableOffset + i * SCHEMA_STRING_ENTRY_SIZE;
+        const quint64 offset = readUInt32(entry, 0);
+        const quint64 length = readUInt32(entry, 1);
+
+        if (offset % 2 != 0 || offset + length * sizeof(QChar) > size)
+            return invalid(QString("string %1 is out of the file").arg(i));
+    }
+
+    for (quint64 i = 0; i < count; ++i)
+    {
+        const uchar *data = m_data + m_propertiesOffset + i * SCHEMA_RECORD_SIZE;
+
+        const bool areStringsValid = readUInt32(data, NameField) < m_stringsCount && readUInt32(data, TypeField) < m_stringsCount &&
+                                     (readUInt32(data, CategoryField) < m_stringsCount || readUInt32(data, CategoryField) == NO_STRING) &&
+                                     (readUInt32(data, DescriptionField) < m_stringsCount || readUInt32(data, DescriptionField) == NO_STRING);
+
+        if (!areStringsValid || quint64(readUInt32(data, DefaultValueOffsetField)) + readUInt32(data, DefaultValueSizeField) > valuesSize)
+            return invalid(QString("property %1 is corrupt").arg(i));
+    }
+
+    m_count = int(count);
+    m_typeIds.assign(m_stringsCount, UNRESOLVED_TYPE);
+    m_ownedStrings.assign(m_stringsCount, QString());
+
+    return true;
+#endif
+}
+
+void PropertySchemaFile::close()
+{
+    if (m_data != nullptr)
+        m_file.unmap(const_cast<uchar *>(m_data));
+
+    m_file.close();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_count = 0;
+    m_stringsCount = 0;
+    m_typeIds.clear();
+    m_ownedStrings.clear();
+    m_nextIndex = 0;
+}
+
+bool PropertySchemaFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+int PropertySchemaFile::count() const
+{
+    return m_count;
+}
+
+QString PropertySchemaFile::name(int index) const
+{
+    return string(readUInt32(record(index), NameField));
+}
+
+QString PropertySchemaFile::category(int index) const
+{
+    return string(readUInt32(record(index), CategoryField));
+}
+
+QString PropertySchemaFile::description(int index) const
+{
+    return string(readUInt32(record(index), DescriptionField));
+}
+
+int PropertySchemaFile::type(int index) const
+{
+    const quint32 stringIndex = readUInt32(record(index), TypeField);
+
+    // NOTE: unknown types stay unresolved, they might get registered later on
+    int &result = m_typeIds[stringIndex];
+    if (result == UNRESOLVED_TYPE || result == QMetaType::UnknownType)
+        result = internal::getMetaTypeId(string(stringIndex).toLatin1());
+
+    return result;
+}
+
+bool PropertySchemaFile::hasReadOnly(int index) const
+{
+    return (readUInt32(record(index), FlagsField) & HasReadOnlyFlag) != 0;
+}
+
+bool PropertySchemaFile::isReadOnly(int index) const
+{
+    return (readUInt32(record(index), FlagsField) & ReadOnlyFlag) != 0;
+}
+
+bool PropertySchemaFile::hasDefaultValue(int index) const
+{
+    return readUInt32(record(index), DefaultValueSizeField) != 0;
+}
+
+QVariant PropertySchemaFile::defaultValue(int index) const
+{
+    const uchar *data = record(index);
+    const quint32 size = readUInt32(data, DefaultValueSizeField);
+
+    if (size == 0)
+        return QVariant();
+
+    // the bytes are read in place
+    const char *value = reinterpret_cast<const char *>(m_data + m_valuesOffset + readUInt32(data, DefaultValueOffsetField));
+    const QByteArray bytes = QByteArray::fromRawData(value, int(size));
+
+    QDataStream stream(bytes);
+    stream.setVersion(SCHEMA_VALUES_STREAM_VERSION);
+
+    QVariant result;
+    stream >> result;
+
+    return result;
+}
+
+void PropertySchemaFile::property(int index, Property &property, QVariant &value) const
+{
+    const int typeId = type(index);
+
+    // NOTE: the properties outlive the mapping (they end up in the models of the grids), they never point into it
+    const uchar *data = record(index);
+
+    property = Property(ownedString(readUInt32(data, NameField)), typeId);
+
+    const QString propertyCategory = ownedString(readUInt32(data, CategoryField));
+    if (!propertyCategory.isNull())
+        property.addAttribute(CategoryAttribute(propertyCategory));
+
+    const QString propertyDescription = ownedString(readUInt32(data, DescriptionField));
+    if (!propertyDescription.isNull())
+        property.addAttribute(DescriptionAttribute(propertyDescription));
+
+    if (hasReadOnly(index))
+        property.addAttribute(ReadOnlyAttribute(isReadOnly(index)));
+
+    if (hasDefaultValue(index))
+    {
+        value = defaultValue(index);
+        property.addAttribute(DefaultValueAttribute(value));
+    }
+    else
+    {
+        value = internal::createDefaultVariantForType(typeId);
+    }
+}
+
+bool PropertySchemaFile::readNext(Property &property, QVariant &value)
+{
+    if (m_nextIndex >= m_count)
+        return false;
+
+    this->property(m_nextIndex++, property, value);
+
+    return true;
+}
+
+const uchar *PropertySchemaFile::record(int index) const
+{
+    return m_data + m_propertiesOffset + quint32(index) * SCHEMA_RECORD_SIZE;
+}
+
+QString PropertySchemaFile::string(quint32 stringIndex) const
+{
+    if (stringIndex == NO_STRING)
+        return QString();
+
+    const uchar *entry = m_data + m_stringTableOffset + stringIndex * SCHEMA_STRING_ENTRY_SIZE;
+
+    // NOTE: no copy, the string points into the mapping
+    return QString::fromRawData(reinterpret_cast<const QChar *>(m_data + readUInt32(entry, 0)), int(readUInt32(entry, 1)));
+}
+
+QString PropertySchemaFile::ownedString(quint32 stringIndex) const
+{
+    if (stringIndex == NO_STRING)
+        return QString();
+
+    QString &result = m_ownedStrings[stringIndex];
+    if (result.isNull())
+    {
+        const QString view = string(stringIndex);
+        result = QString(view.unicode(), view.size());
+    }
+
+    return result;
+}
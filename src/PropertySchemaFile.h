@@ -0,0 +1,87 @@
+#ifndef PROPERTYSCHEMAFILE_H
+#define PROPERTYSCHEMAFILE_H
+
+#include "Property.h"
+
+#include <QFile>
+
+#include <vector>
+
+class QIODevice;
+
+namespace PM
+{
+//
+// A compiled schema: property descriptors and their basic attributes (category, description, default value and
+// read-only) in a versioned binary file with interned strings and offset tables, see compile().
+//
+// The file gets memory-mapped when opened. name(), category() and description() are served straight from the mapping
+// (QString::fromRawData) without copying anything. Only the default values get decoded, and only when asked for.
+//
+// The properties created by property() and readNext() own their strings, each string of the file gets copied once
+// and is then shared by all the properties that use it (categories in particular). They stay valid after the schema
+// got closed, so they can safely be handed to a grid.
+//
+// WARNING: the strings returned by name(), category() and description() point into the mapping, they must not be
+//          used once the schema got closed or destroyed
+//
+// readNext() fits PropertyGrid::populateProperties(), see PropertySchemaReader.
+//
+class PropertySchemaFile
+{
+public:
+    // writes the schema to the device, fails on default values that QDataStream can't serialize
+    static bool compile(const std::vector<Property> &properties, QIODevice *device, QString *errorMessage = nullptr);
+
+public:
+    PropertySchemaFile();
+    ~PropertySchemaFile();
+
+    PropertySchemaFile(const PropertySchemaFile &) = delete;
+    PropertySchemaFile &operator=(const PropertySchemaFile &) = delete;
+
+    // validates all the tables up front, the accessors below don't check anything
+    bool open(const QString &fileName, QString *errorMessage = nullptr);
+    void close();
+    bool isOpen() const;
+
+    int count() const;
+
+    QString name(int index) const;
+    QString category(int index) const;    // a null string when the property doesn't have one
+    QString description(int index) const; // a null string when the property doesn't have one
+    int type(int index) const;            // QMetaType::UnknownType when the type isn't registered (yet)
+    bool hasReadOnly(int index) const;
+    bool isReadOnly(int index) const;
+    bool hasDefaultValue(int index) const;
+    QVariant defaultValue(int index) const;
+
+    // the property along with its attributes, the value is its default value
+    void property(int index, Property &property, QVariant &value) const;
+
+    // returns the properties in order, false once they were all read
+    bool readNext(Property &property, QVariant &value);
+
+private:
+    const uchar *record(int index) const;
+    QString string(quint32 stringIndex) const;
+    QString ownedString(quint32 stringIndex) const;
+
+private:
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+
+    int m_count;
+    quint32 m_stringsCount;
+    quint32 m_propertiesOffset;
+    quint32 m_stringTableOffset;
+    quint32 m_valuesOffset;
+
+    mutable std::vector<int> m_typeIds;         // by string index, resolved on first use
+    mutable std::vector<QString> m_ownedStrings; // by string index, copied out of the mapping on first use
+    int m_nextIndex;
+};
+} // namespace PM
+
+#endif // PROPERTYSCHEMAFILE_H
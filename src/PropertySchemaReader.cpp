@@ -0,0 +1,727 @@
+#include "PropertySchemaReader.h"
+
+#include "QtCompat_p.h"
+
+#include <QIODevice>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborStreamReader>
+#endif
+
+#include <vector>
+
+namespace PM
+{
+namespace internal
+{
+    // pulls the schema one token at a time, the keys of maps are plain string scalars
+    class SchemaTokenizer
+    {
+    public:
+        enum TokenType
+        {
+            ArrayStart,
+            MapStart,
+            ContainerEnd,
+            Scalar, // strings, numbers, booleans and byte arrays, null is an invalid variant
+            End,
+            Error,
+        };
+
+    public:
+        virtual ~SchemaTokenizer() = default;
+
+        virtual TokenType next(QVariant &scalar) = 0;
+
+        QString errorString() const
+        {
+            return m_errorString;
+        }
+
+    protected:
+        TokenType fail(const QString &errorMessage)
+        {
+            m_errorString = errorMessage;
+
+            return Error;
+        }
+
+    private:
+        QString m_errorString;
+    };
+} // namespace internal
+} // namespace PM
+
+namespace
+{
+using PM::internal::SchemaTokenizer;
+
+// the device is read in blocks of this size, a schema never has to fit in memory as a whole
+const qint64 SCHEMA_READ_BLOCK_SIZE = 64 * 1024;
+
+class JsonTokenizer : public SchemaTokenizer
+{
+public:
+    explicit JsonTokenizer(QIODevice *device) : m_device(device), m_position(0), m_offset(0), m_isRootRead(false)
+    {
+    }
+
+    TokenType next(QVariant &scalar) override
+    {
+        char c = skipWhitespace();
+
+        if (c == '\0')
+            return m_containers.empty() ? End : failAt("unexpected end of the schema");
+
+        if (m_containers.empty())
+        {
+            if (m_isRootRead)
+                return failAt(QString("unexpected '%1' after the end of the schema").arg(QLatin1Char(c)));
+
+            m_isRootRead = true;
+        }
+        else
+        {
+            // the separators are checked against what the container expects at this point, then skipped
+            Container &container = m_containers.back();
+
+            switch (container.state)
+            {
+            case Container::AfterValue:
+                if (c == container.closing)
+                    break;
+
+                if (c != ',')
+                    return failAt(QString("expected ',' or '%1'").arg(QLatin1Char(container.closing)));
+
+                take();
+                c = skipWhitespace();
+                container.state = container.closing == '}' ? Container::ExpectingKey : Container::ExpectingValue;
+                break;
+
+            case Container::AfterKey:
+                if (c != ':')
+                    return failAt("expected ':' after the key");
+
+                take();
+                c = skipWhitespace();
+                container.state = Container::ExpectingValue;
+                break;
+
+            default:
+                break;
+            }
+
+            const bool isClosing = c == ']' || c == '}';
+
+            if (isClosing && container.state != Container::AfterValue && container.state != Container::Empty)
+                return failAt(QString("unexpected '%1'").arg(QLatin1Char(c)));
+
+            const bool isExpectingKey =
+                container.closing == '}' && (container.state == Container::Empty || container.state == Container::ExpectingKey);
+
+            if (!isClosing && isExpectingKey && c != '"')
+                return failAt("expected a string key");
+
+            // NOTE: a value that is a container gets read in full before its parent looks at the next separator
+            if (!isClosing)
+                container.state = isExpectingKey ? Container::AfterKey : Container::AfterValue;
+        }
+
+        switch (c)
+        {
+        case '\0':
+            return failAt("unexpected end of the schema");
+
+        case '[':
+        case '{':
+            take();
+            m_containers.push_back(Container{c == '[' ? ']' : '}', Container::Empty});
+            return c == '[' ? ArrayStart : MapStart;
+
+        case ']':
+        case '}':
+            if (m_containers.empty() || m_containers.back().closing != c)
+                return failAt(QString("unexpected '%1'").arg(QLatin1Char(c)));
+
+            take();
+            m_containers.pop_back();
+            return ContainerEnd;
+
+        case '"':
+            return readString(scalar);
+
+        case 't':
+            return readLiteral("true", true, scalar);
+
+        case 'f':
+            return readLiteral("false", false, scalar);
+
+        case 'n':
+            return readLiteral("null", QVariant(), scalar);
+
+        default:
+            if (c == '-' || (c >= '0' && c <= '9'))
+                return readNumber(scalar);
+
+            return failAt(QString("unexpected '%1'").arg(QLatin1Char(c)));
+        }
+    }
+
+private:
+    struct Container
+    {
+        enum State
+        {
+            Empty,          // nothing read yet, a value (a key in maps) or the end of the container may follow
+            ExpectingKey,   // after a ',' in a map
+            AfterKey,       // a ':' has to follow
+            ExpectingValue, // after a ',' in an array or a ':' in a map
+            AfterValue,     // a ',' or the end of the container has to follow
+        };
+
+        char closing; // ']' or '}'
+        State state;
+    };
+
+private:
+    char skipWhitespace()
+    {
+        char c = peek();
+        while (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        {
+            take();
+            c = peek();
+        }
+
+        return c;
+    }
+
+    bool fill()
+    {
+        if (m_position < m_buffer.size())
+            return true;
+
+        m_offset += m_buffer.size();
+        m_buffer = m_device->read(SCHEMA_READ_BLOCK_SIZE);
+        m_position = 0;
+
+        return !m_buffer.isEmpty();
+    }
+
+    char peek()
+    {
+        return fill() ? m_buffer.at(m_position) : '\0';
+    }
+
+    char take()
+    {
+        return fill() ? m_buffer.at(m_position++) : '\0';
+    }
+
+    TokenType failAt(const QString &errorMessage)
+    {
+        return fail(QString("%1 at byte %2").arg(errorMessage).arg(m_offset + m_position));
+    }
+
+    bool readHex(ushort &result)
+    {
+        result = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = take();
+            const int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+
+            if (digit < 0)
+                return false;
+
+            result = ushort(result * 16 + digit);
+        }
+
+        return true;
+    }
+
+    TokenType readString(QVariant &scalar)
+    {
+        take(); // the opening quote
+
+        QByteArray bytes;
+
+        while (true)
+        {
+            if (!fill())
+                return failAt("unterminated string");
+
+            // the plain characters are copied in runs
+            const int start = m_position;
+            while (m_position < m_buffer.size() && m_buffer.at(m_position) != '"' && m_buffer.at(m_position) != '\\')
+                ++m_position;
+
+            bytes.append(m_buffer.constData() + start, m_position - start);
+
+            if (m_position == m_buffer.size())
+                continue;
+
+            if (take() == '"')
+                break;
+
+            const char escaped = take();
+            switch (escaped)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                bytes.append(escaped);
+                break;
+
+            case 'b':
+                bytes.append('\b');
+                break;
+
+            case 'f':
+                bytes.append('\f');
+                break;
+
+            case 'n':
+                bytes.append('\n');
+                break;
+
+            case 'r':
+                bytes.append('\r');
+                break;
+
+            case 't':
+                bytes.append('\t');
+                break;
+
+            case 'u':
+            {
+                ushort unit = 0;
+                if (!readHex(unit))
+                    return failAt("invalid \\u escape");
+
+                QString text(QChar(unit));
+
+                // characters outside of the BMP are escaped as surrogate pairs
+                if (QChar::isHighSurrogate(unit))
+                {
+                    ushort lowUnit = 0;
+                    if (take() != '\\' || take() != 'u' || !readHex(lowUnit) || !QChar::isLowSurrogate(lowUnit))
+                        return failAt("invalid surrogate pair");
+
+                    text.append(QChar(lowUnit));
+                }
+
+                bytes.append(text.toUtf8());
+                break;
+            }
+
+            default:
+                return failAt("invalid escape sequence");
+            }
+        }
+
+        scalar = QString::fromUtf8(bytes);
+
+        return Scalar;
+    }
+
+    TokenType readNumber(QVariant &scalar)
+    {
+        QByteArray text;
+        bool isInteger = true;
+
+        for (char c = peek(); c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9'); c = peek())
+        {
+            isInteger = isInteger && c != '.' && c != 'e' && c != 'E';
+            text.append(take());
+        }
+
+        bool ok = false;
+
+        if (isInteger)
+        {
+            const qlonglong integer = text.toLongLong(&ok);
+            if (ok)
+                scalar = integer;
+        }
+
+        // integers that don't fit in 64 bits end up as doubles, like in QJsonValue
+        if (!ok)
+        {
+            const double number = text.toDouble(&ok);
+            if (!ok)
+                return failAt(QString("invalid number \"%1\"").arg(QString::fromLatin1(text)));
+
+            scalar = number;
+        }
+
+        return Scalar;
+    }
+
+    TokenType readLiteral(const char *literal, const QVariant &value, QVariant &scalar)
+    {
+        for (const char *c = literal; *c != '\0'; ++c)
+        {
+            if (take() != *c)
+                return failAt(QString("invalid literal, expected \"%1\"").arg(QString::fromLatin1(literal)));
+        }
+
+        scalar = value;
+
+        return Scalar;
+    }
+
+private:
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    int m_position;
+    qint64 m_offset; // of the buffer in the device
+    std::vector<Container> m_containers; // the containers being read, innermost last
+    bool m_isRootRead; // a schema is a single value
+};
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+class CborTokenizer : public SchemaTokenizer
+{
+public:
+    explicit CborTokenizer(QIODevice *device) : m_reader(device), m_depth(0)
+    {
+    }
+
+    TokenType next(QVariant &scalar) override
+    {
+        // NOTE: the end of a container only shows as there being no next item in it
+        if (m_depth > 0 && !m_reader.hasNext())
+        {
+            if (!m_reader.leaveContainer())
+                return failWithReader();
+
+            --m_depth;
+            return ContainerEnd;
+        }
+
+        // tags (dates, URLs, ...) are skipped, the values they apply to are read as they are
+        while (m_reader.isTag())
+            m_reader.next();
+
+        switch (m_reader.type())
+        {
+        case QCborStreamReader::UnsignedInteger:
+        case QCborStreamReader::NegativeInteger:
+            scalar = qlonglong(m_reader.toInteger());
+            return advance();
+
+        case QCborStreamReader::ByteArray:
+        {
+            QByteArray bytes;
+
+            auto chunk = m_reader.readByteArray();
+            for (; chunk.status == QCborStreamReader::Ok; chunk = m_reader.readByteArray())
+                bytes.append(chunk.data);
+
+            if (chunk.status == QCborStreamReader::Error)
+                return failWithReader();
+
+            scalar = bytes;
+            return Scalar;
+        }
+
+        case QCborStreamReader::String:
+        {
+            QString text;
+
+            auto chunk = m_reader.readString();
+            for (; chunk.status == QCborStreamReader::Ok; chunk = m_reader.readString())
+                text.append(chunk.data);
+
+            if (chunk.status == QCborStreamReader::Error)
+                return failWithReader();
+
+            scalar = text;
+            return Scalar;
+        }
+
+        case QCborStreamReader::Array:
+        case QCborStreamReader::Map:
+        {
+            const bool isArray = m_reader.isArray();
+
+            if (!m_reader.enterContainer())
+                return failWithReader();
+
+            ++m_depth;
+            return isArray ? ArrayStart : MapStart;
+        }
+
+        case QCborStreamReader::SimpleType:
+            if (m_reader.isBool())
+                scalar = m_reader.toBool();
+            else if (m_reader.isNull() || m_reader.isUndefined())
+                scalar = QVariant();
+            else
+                return fail(QString("unsupported simple type %1").arg(int(m_reader.toSimpleType())));
+
+            return advance();
+
+        case QCborStreamReader::Float16:
+            scalar = double(m_reader.toFloat16());
+            return advance();
+
+        case QCborStreamReader::Float:
+            scalar = double(m_reader.toFloat());
+            return advance();
+
+        case QCborStreamReader::Double:
+            scalar = m_reader.toDouble();
+            return advance();
+
+        default:
+            if (m_depth == 0 && (m_reader.lastError() == QCborError::NoError || m_reader.lastError() == QCborError::EndOfFile))
+                return End;
+
+            return failWithReader();
+        }
+    }
+
+private:
+    TokenType advance()
+    {
+        return m_reader.next() ? Scalar : failWithReader();
+    }
+
+    TokenType failWithReader()
+    {
+        return fail(QString("%1 at byte %2").arg(m_reader.lastError().toString()).arg(m_reader.currentOffset()));
+    }
+
+private:
+    QCborStreamReader m_reader;
+    int m_depth;
+};
+#endif
+
+bool readValue(SchemaTokenizer &tokenizer, SchemaTokenizer::TokenType token, QVariant &scalar, QVariant &value, QString *errorMessage)
+{
+    switch (token)
+    {
+    case SchemaTokenizer::Scalar:
+        value = scalar;
+        return true;
+
+    case SchemaTokenizer::ArrayStart:
+    {
+        QVariantList list;
+
+        for (token = tokenizer.next(scalar); token != SchemaTokenizer::ContainerEnd; token = tokenizer.next(scalar))
+        {
+            QVariant element;
+            if (!readValue(tokenizer, token, scalar, element, errorMessage))
+                return false;
+
+            list.append(element);
+        }
+
+        value = list;
+        return true;
+    }
+
+    case SchemaTokenizer::MapStart:
+    {
+        QVariantMap map;
+
+        for (token = tokenizer.next(scalar); token != SchemaTokenizer::ContainerEnd; token = tokenizer.next(scalar))
+        {
+            if (token == SchemaTokenizer::Error)
+            {
+                *errorMessage = tokenizer.errorString();
+                return false;
+            }
+
+            if (token != SchemaTokenizer::Scalar || PM::internal::getVariantTypeId(scalar) != QMetaType::QString)
+            {
+                *errorMessage = "the keys of objects must be strings";
+                return false;
+            }
+
+            const QString key = scalar.toString();
+
+            QVariant element;
+            if (!readValue(tokenizer, tokenizer.next(scalar), scalar, element, errorMessage))
+                return false;
+
+            map.insert(key, element);
+        }
+
+        value = map;
+        return true;
+    }
+
+    case SchemaTokenizer::Error:
+        *errorMessage = tokenizer.errorString();
+        return false;
+
+    default:
+        *errorMessage = "unexpected end of a value";
+        return false;
+    }
+}
+
+bool convertValue(QVariant &value, int typeId)
+{
+    if (PM::internal::getVariantTypeId(value) == typeId)
+        return true;
+
+    return PM::internal::canConvert(value, typeId) && PM::internal::convertVariant(value, typeId);
+}
+} // namespace
+
+using namespace PM;
+
+PropertySchemaReader::PropertySchemaReader(QIODevice *device, Format format) : m_isStarted(false), m_isFinished(false), m_readCount(0)
+{
+    switch (format)
+    {
+    case Json:
+        m_tokenizer = std::make_unique<JsonTokenizer>(device);
+        break;
+
+    case Cbor:
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+        m_tokenizer = std::make_unique<CborTokenizer>(device);
+#else
+        m_errorString = "CBOR schemas need Qt 5.12 or newer";
+#endif
+        break;
+    }
+}
+
+PropertySchemaReader::~PropertySchemaReader() = default;
+
+bool PropertySchemaReader::readNext(Property &property, QVariant &value)
+{
+    if (m_tokenizer == nullptr || m_isFinished || hasError())
+        return false;
+
+    QVariant scalar;
+
+    if (!m_isStarted)
+    {
+        m_isStarted = true;
+
+        const SchemaTokenizer::TokenType token = m_tokenizer->next(scalar);
+        if (token == SchemaTokenizer::Error)
+            return fail(m_tokenizer->errorString());
+        if (token != SchemaTokenizer::ArrayStart)
+            return fail("the schema must be an array of properties");
+    }
+
+    SchemaTokenizer::TokenType token = m_tokenizer->next(scalar);
+
+    if (token == SchemaTokenizer::ContainerEnd)
+    {
+        m_isFinished = true;
+        return false;
+    }
+
+    if (token == SchemaTokenizer::Error)
+        return fail(m_tokenizer->errorString());
+    if (token != SchemaTokenizer::MapStart)
+        return fail("properties must be objects");
+
+    QString name;
+    QString typeName;
+    QVariant description;
+    QVariant category;
+    QVariant defaultValue;
+    QVariant readOnly;
+    QVariant initialValue;
+
+    for (token = m_tokenizer->next(scalar); token != SchemaTokenizer::ContainerEnd; token = m_tokenizer->next(scalar))
+    {
+        if (token == SchemaTokenizer::Error)
+            return fail(m_tokenizer->errorString());
+        if (token != SchemaTokenizer::Scalar || internal::getVariantTypeId(scalar) != QMetaType::QString)
+            return fail("the keys of a property must be strings");
+
+        const QString key = scalar.toString();
+
+        QVariant keyValue;
+        QString errorMessage;
+        if (!readValue(*m_tokenizer, m_tokenizer->next(scalar), scalar, keyValue, &errorMessage))
+            return fail(errorMessage);
+
+        if (key == QLatin1String("name"))
+            name = keyValue.toString();
+        else if (key == QLatin1String("type"))
+            typeName = keyValue.toString();
+        else if (key == QLatin1String("description"))
+            description = keyValue;
+        else if (key == QLatin1String("category"))
+            category = keyValue;
+        else if (key == QLatin1String("default"))
+            defaultValue = keyValue;
+        else if (key == QLatin1String("readOnly"))
+            readOnly = keyValue;
+        else if (key == QLatin1String("value"))
+            initialValue = keyValue;
+    }
+
+    if (name.isEmpty())
+        return fail("a property without a name");
+
+    const int typeId = internal::getMetaTypeId(typeName.toLatin1());
+    if (typeId == QMetaType::UnknownType)
+        return fail(QString("unknown type \"%1\" of property \"%2\"").arg(typeName, name));
+
+    property = Property(name, typeId);
+
+    if (description.isValid())
+        property.addAttribute(DescriptionAttribute(description.toString()));
+
+    if (category.isValid())
+        property.addAttribute(CategoryAttribute(category.toString()));
+
+    if (readOnly.isValid())
+        property.addAttribute(ReadOnlyAttribute(readOnly.toBool()));
+
+    if (defaultValue.isValid())
+    {
+        if (!convertValue(defaultValue, typeId))
+            return fail(QString("the default value of property \"%1\" isn't a %2").arg(name, typeName));
+
+        property.addAttribute(DefaultValueAttribute(defaultValue));
+    }
+
+    value = initialValue.isValid() ? initialValue : defaultValue.isValid() ? defaultValue : internal::createDefaultVariantForType(typeId);
+
+    if (!convertValue(value, typeId))
+        return fail(QString("the value of property \"%1\" isn't a %2").arg(name, typeName));
+
+    ++m_readCount;
+
+    return true;
+}
+
+bool PropertySchemaReader::hasError() const
+{
+    return !m_errorString.isEmpty();
+}
+
+QString PropertySchemaReader::errorString() const
+{
+    return m_errorString;
+}
+
+int PropertySchemaReader::readCount() const
+{
+    return m_readCount;
+}
+
+bool PropertySchemaReader::fail(const QString &errorMessage)
+{
+    m_errorString = QString("%1 (property %2)").arg(errorMessage).arg(m_readCount);
+
+    return false;
+}
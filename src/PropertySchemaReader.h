@@ -0,0 +1,74 @@
+#ifndef PROPERTYSCHEMAREADER_H
+#define PROPERTYSCHEMAREADER_H
+
+#include "Property.h"
+
+#include <memory>
+
+class QIODevice;
+
+namespace PM
+{
+namespace internal
+{
+    class SchemaTokenizer;
+}
+
+//
+// Reads property descriptors out of a JSON or CBOR schema one at a time, without building a document of the whole file.
+// The schema is an array of objects:
+//
+//     [
+//         { "name": "Width", "type": "int", "category": "Geometry", "description": "in pixels", "default": 50, "value": 100 },
+//         { "name": "Id", "type": "QString", "readOnly": true },
+//         ...
+//     ]
+//
+// "name" and "type" (the name of the meta type) are required. "value" is the initial value, the default value or a
+// default constructed one is used without it. Values get converted to the type of the property, unknown keys are
+// skipped so that the schemas can carry data of their own.
+//
+// readNext() fits PropertyGrid::populateProperties(), which feeds the grid in time-budgeted batches. Along with
+// PropertyGrid::setCategoriesExpandedByDefault(false), the items of a category only get created once it is expanded:
+//
+//     auto reader = std::make_shared<PM::PropertySchemaReader>(file, PM::PropertySchemaReader::Json);
+//     grid.populateProperties([reader](PM::Property &property, QVariant &value) { return reader->readNext(property, value); });
+//
+class PropertySchemaReader
+{
+public:
+    enum Format
+    {
+        Json,
+        Cbor, // needs Qt 5.12 or newer
+    };
+
+public:
+    // the device must be open for reading and outlive the reader
+    PropertySchemaReader(QIODevice *device, Format format);
+    ~PropertySchemaReader();
+
+    PropertySchemaReader(const PropertySchemaReader &) = delete;
+    PropertySchemaReader &operator=(const PropertySchemaReader &) = delete;
+
+    // returns false at the end of the schema, as well as on the first error
+    bool readNext(Property &property, QVariant &value);
+
+    bool hasError() const;
+    QString errorString() const; // along with the index of the property it happened at
+
+    int readCount() const;
+
+private:
+    bool fail(const QString &errorMessage);
+
+private:
+    std::unique_ptr<internal::SchemaTokenizer> m_tokenizer;
+    bool m_isStarted;
+    bool m_isFinished;
+    int m_readCount;
+    QString m_errorString;
+};
+} // namespace PM
+
+#endif // PROPERTYSCHEMAREADER_H
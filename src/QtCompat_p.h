@@ -11,6 +11,8 @@
 //
 //
 
+#include <QFontDatabase>
+#include <QMetaType>
 #include <QModelIndex>
 
 namespace PM
@@ -34,6 +36,16 @@ namespace internal
 #endif
     }
 
+    // NOTE: thread-safe, the font families get enumerated in the background
+    inline QStringList fontFamilies()
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return QFontDatabase::families();
+#else
+        return QFontDatabase().families();
+#endif
+    }
+
     inline QString getMetaTypeName(int typeId)
     {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
@@ -43,6 +55,37 @@ namespace internal
 #endif
     }
 
+    inline int getMetaTypeId(const QByteArray &typeName)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return QMetaType::fromName(typeName).id();
+#else
+        return QMetaType::type(typeName.constData());
+#endif
+    }
+
+    // NOTE: pointers never count, streaming them would write out an address that means nothing once read back
+    inline bool hasDataStreamOperators(int typeId)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        const QMetaType metaType(typeId);
+
+        return metaType.hasRegisteredDataStreamOperators() && !metaType.flags().testFlag(QMetaType::IsPointer);
+#else
+        // NOTE: Qt5 has no way to ask, only the built-in types are known to have them (but the pointers among them)
+        switch (typeId)
+        {
+        case QMetaType::VoidStar:
+        case QMetaType::QObjectStar:
+        case QMetaType::Nullptr:
+            return false;
+
+        default:
+            return typeId > QMetaType::UnknownType && typeId < QMetaType::User;
+        }
+#endif
+    }
+
     inline int getVariantTypeId(const QVariant &value)
     {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -64,6 +107,15 @@ namespace internal
 #endif
     }
 
+    inline bool convertVariant(QVariant &value, int typeId)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return value.convert(QMetaType(typeId));
+#else
+        return value.convert(typeId);
+#endif
+    }
+
     inline StringRef_t stringLeft(const QString &input, int n)
     {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -86,6 +138,33 @@ namespace internal
 #endif
     }
 
+    inline const QMetaObject *getMetaObjectForType(int typeId)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return QMetaType(typeId).metaObject();
+#else
+        return QMetaType::metaObjectForType(typeId);
+#endif
+    }
+
+    inline bool isGadgetType(int typeId)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return QMetaType(typeId).flags().testFlag(QMetaType::IsGadget);
+#else
+        return QMetaType::typeFlags(typeId).testFlag(QMetaType::IsGadget);
+#endif
+    }
+
+    inline bool isQObjectPointerType(int typeId)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return QMetaType(typeId).flags().testFlag(QMetaType::PointerToQObject);
+#else
+        return QMetaType::typeFlags(typeId).testFlag(QMetaType::PointerToQObject);
+#endif
+    }
+
     // TODO: is this function really needed?!!
     inline QVariant createDefaultVariantForType(int type)
     {
@@ -0,0 +1,70 @@
+#include <PropertySchemaFile.h>
+#include <PropertySchemaReader.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+//
+// Compiles a JSON or CBOR schema (see PropertySchemaReader) into the binary format of PropertySchemaFile.
+//
+// usage: property_schema_compiler <schema.json|schema.cbor> <output>
+//
+// NOTE: only the descriptors are compiled, the grid starts every property at its default value
+//
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList arguments = app.arguments();
+    if (arguments.size() != 3)
+    {
+        err << "usage: property_schema_compiler <schema.json|schema.cbor> <output>\n";
+        return 1;
+    }
+
+    QFile input(arguments[1]);
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        err << "cannot open " << input.fileName() << ": " << input.errorString() << "\n";
+        return 1;
+    }
+
+    const bool isCbor = QFileInfo(input.fileName()).suffix().compare("cbor", Qt::CaseInsensitive) == 0;
+    PM::PropertySchemaReader reader(&input, isCbor ? PM::PropertySchemaReader::Cbor : PM::PropertySchemaReader::Json);
+
+    std::vector<PM::Property> properties;
+
+    PM::Property property;
+    QVariant value;
+    while (reader.readNext(property, value))
+        properties.push_back(property);
+
+    if (reader.hasError())
+    {
+        err << input.fileName() << ": " << reader.errorString() << "\n";
+        return 1;
+    }
+
+    QFile output(arguments[2]);
+    if (!output.open(QIODevice::WriteOnly))
+    {
+        err << "cannot open " << output.fileName() << ": " << output.errorString() << "\n";
+        return 1;
+    }
+
+    QString errorMessage;
+    if (!PM::PropertySchemaFile::compile(properties, &output, &errorMessage))
+    {
+        err << output.fileName() << ": " << errorMessage << "\n";
+        output.remove();
+        return 1;
+    }
+
+    out << "compiled " << properties.size() << " properties into " << output.fileName() << " (" << output.size() << " bytes)\n";
+
+    return 0;
+}